@@ -0,0 +1,341 @@
+/*
+ *   Copyright (c) 2022 Martijn van Welie
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy
+ *   of this software and associated documentation files (the "Software"), to deal
+ *   in the Software without restriction, including without limitation the rights
+ *   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *   copies of the Software, and to permit persons to whom the Software is
+ *   furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included in all
+ *   copies or substantial portions of the Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *   SOFTWARE.
+ *
+ */
+
+/*
+ * Benchmark harness measuring discovery rate, service-resolution time,
+ * notification throughput and write round-trip latency.
+ *
+ * Run "benchmark peripheral" on one adapter (or machine) and
+ * "benchmark central" on another. The peripheral advertises a benchmark
+ * service with a characteristic notifying a counter at a fixed rate and a
+ * writable characteristic. The central then runs through four phases:
+ *
+ *   1. scan for 10 seconds and report discovery results/sec
+ *   2. connect and report the connect + service-resolution time
+ *   3. subscribe and report sustained notifications/sec over 10 seconds
+ *   4. do 200 writes-with-response and report the latency distribution
+ */
+
+#include <glib.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <signal.h>
+#include "adapter.h"
+#include "device.h"
+#include "application.h"
+#include "advertisement.h"
+#include "characteristic.h"
+#include "logger.h"
+
+#define TAG "Benchmark"
+#define BENCHMARK_SERVICE_UUID "0000b00c-0000-1000-8000-00805f9b34fb"
+#define NOTIFY_CHAR_UUID "0000b001-0000-1000-8000-00805f9b34fb"
+#define WRITE_CHAR_UUID "0000b002-0000-1000-8000-00805f9b34fb"
+
+#define NOTIFY_INTERVAL_MS 20
+#define PAYLOAD_SIZE 20
+#define DISCOVERY_SECONDS 10
+#define NOTIFY_SECONDS 10
+#define WRITE_COUNT 200
+
+GMainLoop *loop = NULL;
+Adapter *default_adapter = NULL;
+Application *app = NULL;
+Advertisement *advertisement = NULL;
+
+// Peripheral state
+guint notify_timer = 0;
+guint32 notify_counter = 0;
+
+// Central state
+Device *target_device = NULL;
+guint discovery_results = 0;
+gint64 connect_started = 0;
+gint64 notify_started = 0;
+guint notifications_received = 0;
+gint64 write_started = 0;
+guint writes_done = 0;
+gint64 write_latencies[WRITE_COUNT];
+
+static gint64 now_millis(void) {
+    return g_get_monotonic_time() / 1000;
+}
+
+/*
+ * Peripheral role
+ */
+
+gboolean on_notify_timer(gpointer data) {
+    guint8 payload[PAYLOAD_SIZE] = {0};
+    notify_counter++;
+    payload[0] = (guint8) (notify_counter & 0xFFu);
+    payload[1] = (guint8) ((notify_counter >> 8) & 0xFFu);
+    payload[2] = (guint8) ((notify_counter >> 16) & 0xFFu);
+    payload[3] = (guint8) ((notify_counter >> 24) & 0xFFu);
+
+    GByteArray *byteArray = g_byte_array_sized_new(PAYLOAD_SIZE);
+    g_byte_array_append(byteArray, payload, PAYLOAD_SIZE);
+    binc_application_notify(app, BENCHMARK_SERVICE_UUID, NOTIFY_CHAR_UUID, byteArray);
+    g_byte_array_free(byteArray, TRUE);
+    return TRUE;
+}
+
+void on_local_char_start_notify(const Application *application, const char *service_uuid, const char *char_uuid) {
+    log_info(TAG, "central subscribed, notifying every %dms", NOTIFY_INTERVAL_MS);
+    if (notify_timer == 0) {
+        notify_timer = g_timeout_add(NOTIFY_INTERVAL_MS, on_notify_timer, NULL);
+    }
+}
+
+void on_local_char_stop_notify(const Application *application, const char *service_uuid, const char *char_uuid) {
+    log_info(TAG, "central unsubscribed");
+    if (notify_timer != 0) {
+        g_source_remove(notify_timer);
+        notify_timer = 0;
+    }
+}
+
+const char *on_local_char_write(const Application *application, const char *address, const char *service_uuid,
+                                const char *char_uuid, GByteArray *byteArray) {
+    return NULL;
+}
+
+void run_peripheral(void) {
+    GPtrArray *adv_service_uuids = g_ptr_array_new();
+    g_ptr_array_add(adv_service_uuids, BENCHMARK_SERVICE_UUID);
+
+    advertisement = binc_advertisement_create();
+    binc_advertisement_set_local_name(advertisement, "BINC-BENCH");
+    binc_advertisement_set_services(advertisement, adv_service_uuids);
+    g_ptr_array_free(adv_service_uuids, TRUE);
+    binc_adapter_start_advertising(default_adapter, advertisement);
+
+    app = binc_create_application(default_adapter);
+    binc_application_add_service(app, BENCHMARK_SERVICE_UUID);
+    binc_application_add_characteristic(app, BENCHMARK_SERVICE_UUID, NOTIFY_CHAR_UUID,
+                                        GATT_CHR_PROP_READ | GATT_CHR_PROP_NOTIFY);
+    binc_application_add_characteristic(app, BENCHMARK_SERVICE_UUID, WRITE_CHAR_UUID,
+                                        GATT_CHR_PROP_WRITE);
+    binc_application_set_char_write_cb(app, &on_local_char_write);
+    binc_application_set_char_start_notify_cb(app, &on_local_char_start_notify);
+    binc_application_set_char_stop_notify_cb(app, &on_local_char_stop_notify);
+    binc_application_set_notify_batching(app, TRUE);
+    binc_adapter_register_application(default_adapter, app);
+
+    log_info(TAG, "peripheral ready, advertising '%s'", BENCHMARK_SERVICE_UUID);
+}
+
+/*
+ * Central role
+ */
+
+static gint compare_latencies(gconstpointer a, gconstpointer b) {
+    gint64 la = *(const gint64 *) a;
+    gint64 lb = *(const gint64 *) b;
+    return (la > lb) - (la < lb);
+}
+
+void report_write_latencies(void) {
+    qsort(write_latencies, WRITE_COUNT, sizeof(gint64), compare_latencies);
+
+    gint64 total = 0;
+    for (guint i = 0; i < WRITE_COUNT; i++) {
+        total += write_latencies[i];
+    }
+
+    log_info(TAG, "write latency over %d writes: min=%ldms mean=%ldms p50=%ldms p95=%ldms max=%ldms",
+             WRITE_COUNT,
+             (long) write_latencies[0],
+             (long) (total / WRITE_COUNT),
+             (long) write_latencies[WRITE_COUNT / 2],
+             (long) write_latencies[(WRITE_COUNT * 95) / 100],
+             (long) write_latencies[WRITE_COUNT - 1]);
+}
+
+void do_next_write(Device *device) {
+    guint8 payload[PAYLOAD_SIZE] = {0};
+    GByteArray *byteArray = g_byte_array_sized_new(PAYLOAD_SIZE);
+    g_byte_array_append(byteArray, payload, PAYLOAD_SIZE);
+    write_started = now_millis();
+    binc_device_write_char(device, BENCHMARK_SERVICE_UUID, WRITE_CHAR_UUID, byteArray, WITH_RESPONSE);
+    g_byte_array_free(byteArray, TRUE);
+}
+
+void on_write(Device *device, Characteristic *characteristic, const GByteArray *byteArray, const GError *error) {
+    if (error != NULL) {
+        log_error(TAG, "write failed (error %d: %s)", error->code, error->message);
+        binc_device_disconnect(device);
+        return;
+    }
+
+    write_latencies[writes_done++] = now_millis() - write_started;
+    if (writes_done < WRITE_COUNT) {
+        do_next_write(device);
+    } else {
+        report_write_latencies();
+        binc_device_disconnect(device);
+    }
+}
+
+gboolean on_notify_window_done(gpointer data) {
+    Device *device = (Device *) data;
+    gint64 elapsed = now_millis() - notify_started;
+
+    log_info(TAG, "notifications: %u in %ldms (%.1f/sec)", notifications_received, (long) elapsed,
+             elapsed > 0 ? (double) notifications_received * 1000.0 / (double) elapsed : 0.0);
+
+    binc_device_stop_notify(device, BENCHMARK_SERVICE_UUID, NOTIFY_CHAR_UUID);
+
+    // Phase 4: write round-trip latency
+    writes_done = 0;
+    do_next_write(device);
+    return FALSE;
+}
+
+void on_notify(Device *device, Characteristic *characteristic, const GByteArray *byteArray) {
+    if (notifications_received == 0) {
+        notify_started = now_millis();
+        g_timeout_add_seconds(NOTIFY_SECONDS, on_notify_window_done, device);
+    }
+    notifications_received++;
+}
+
+void on_services_resolved(Device *device) {
+    log_info(TAG, "service resolution took %ldms", (long) (now_millis() - connect_started));
+
+    // Phase 3: notification throughput
+    binc_device_start_notify(device, BENCHMARK_SERVICE_UUID, NOTIFY_CHAR_UUID);
+}
+
+void on_connection_state_changed(Device *device, ConnectionState state, const GError *error) {
+    if (error != NULL) {
+        log_error(TAG, "(dis)connect failed (error %d: %s)", error->code, error->message);
+        return;
+    }
+
+    if (state == BINC_CONNECTED) {
+        log_info(TAG, "connect took %ldms", (long) (now_millis() - connect_started));
+    } else if (state == BINC_DISCONNECTED) {
+        log_info(TAG, "benchmark done");
+        g_main_loop_quit(loop);
+    }
+}
+
+gboolean on_discovery_window_done(gpointer data) {
+    log_info(TAG, "discovery: %u results in %ds (%.1f/sec)", discovery_results, DISCOVERY_SECONDS,
+             (double) discovery_results / (double) DISCOVERY_SECONDS);
+
+    binc_adapter_stop_discovery(default_adapter);
+
+    if (target_device == NULL) {
+        log_error(TAG, "no peripheral advertising '%s' found", BENCHMARK_SERVICE_UUID);
+        g_main_loop_quit(loop);
+        return FALSE;
+    }
+
+    // Phase 2: connect and resolve services
+    connect_started = now_millis();
+    binc_device_connect(target_device);
+    return FALSE;
+}
+
+void on_scan_result(Adapter *adapter, Device *device) {
+    discovery_results++;
+
+    if (target_device == NULL && binc_device_has_service(device, BENCHMARK_SERVICE_UUID)) {
+        log_info(TAG, "found peripheral '%s' (%s)", binc_device_get_name(device), binc_device_get_address(device));
+        target_device = device;
+        binc_device_set_connection_state_change_cb(device, &on_connection_state_changed);
+        binc_device_set_services_resolved_cb(device, &on_services_resolved);
+        binc_device_set_write_char_cb(device, &on_write);
+        binc_device_set_notify_char_cb(device, &on_notify);
+    }
+}
+
+void run_central(void) {
+    // Phase 1: discovery rate
+    binc_adapter_set_discovery_cb(default_adapter, &on_scan_result);
+    binc_adapter_set_discovery_filter(default_adapter, -127, NULL, NULL);
+    binc_adapter_start_discovery(default_adapter);
+    g_timeout_add_seconds(DISCOVERY_SECONDS, on_discovery_window_done, NULL);
+}
+
+static void cleanup_handler(int signo) {
+    if (signo == SIGINT) {
+        log_error(TAG, "received SIGINT");
+        g_main_loop_quit(loop);
+    }
+}
+
+int main(int argc, char *argv[]) {
+    if (argc < 2 || !(g_str_equal(argv[1], "central") || g_str_equal(argv[1], "peripheral"))) {
+        fprintf(stderr, "usage: %s central|peripheral [adapter]\n", argv[0]);
+        return 1;
+    }
+    gboolean is_central = g_str_equal(argv[1], "central");
+
+    log_enabled(TRUE);
+    log_set_level(LOG_INFO);
+
+    GDBusConnection *dbusConnection = g_bus_get_sync(G_BUS_TYPE_SYSTEM, NULL, NULL);
+
+    if (signal(SIGINT, cleanup_handler) == SIG_ERR)
+        log_error(TAG, "can't catch SIGINT");
+
+    loop = g_main_loop_new(NULL, FALSE);
+
+    default_adapter = argc > 2 ? binc_adapter_get(dbusConnection, argv[2])
+                               : binc_adapter_get_default(dbusConnection);
+    if (default_adapter == NULL) {
+        log_error(TAG, "no adapter found");
+        return 1;
+    }
+
+    log_info(TAG, "using adapter '%s' as %s", binc_adapter_get_name(default_adapter), argv[1]);
+    if (!binc_adapter_get_powered_state(default_adapter)) {
+        binc_adapter_power_on(default_adapter);
+    }
+
+    if (is_central) {
+        run_central();
+    } else {
+        run_peripheral();
+    }
+
+    g_main_loop_run(loop);
+
+    if (app != NULL) {
+        binc_adapter_unregister_application(default_adapter, app);
+        binc_application_free(app);
+    }
+    if (advertisement != NULL) {
+        binc_adapter_stop_advertising(default_adapter, advertisement);
+        binc_advertisement_free(advertisement);
+    }
+    binc_adapter_free(default_adapter);
+
+    g_dbus_connection_close_sync(dbusConnection, NULL, NULL);
+    g_object_unref(dbusConnection);
+    g_main_loop_unref(loop);
+    return 0;
+}
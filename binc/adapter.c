@@ -24,15 +24,20 @@
 #include "adapter.h"
 #include "device.h"
 #include "device_internal.h"
+#include "characteristic_internal.h"
+#include "executor.h"
 #include "logger.h"
+#include "stats.h"
 #include "utility.h"
 #include "advertisement.h"
 #include "application.h"
+#include "object_manager.h"
 
 static const char *const TAG = "Adapter";
 static const char *const BLUEZ_DBUS = "org.bluez";
 static const char *const INTERFACE_ADAPTER = "org.bluez.Adapter1";
 static const char *const INTERFACE_DEVICE = "org.bluez.Device1";
+static const char *const INTERFACE_CHARACTERISTIC = "org.bluez.GattCharacteristic1";
 static const char *const INTERFACE_OBJECT_MANAGER = "org.freedesktop.DBus.ObjectManager";
 static const char *const INTERFACE_GATT_MANAGER = "org.bluez.GattManager1";
 static const char *const INTERFACE_PROPERTIES = "org.freedesktop.DBus.Properties";
@@ -69,6 +74,28 @@ typedef struct binc_discovery_filter {
     const char *pattern;
 } DiscoveryFilter;
 
+typedef struct binc_discovery_report_state {
+    gint64 last_report_millis;
+    short last_rssi;
+} DiscoveryReportState;
+
+#define DEFAULT_CONNECT_MAX_IN_FLIGHT 4
+#define DEFAULT_CONNECT_TIMEOUT_MS 10000
+#define DEFAULT_CONNECT_MAX_RETRIES 2
+#define CONNECT_RETRY_BACKOFF_MS 1000
+
+typedef enum ConnectPhase {
+    CONNECT_ATTEMPTING, CONNECT_WAITING_RETRY
+} ConnectPhase;
+
+typedef struct binc_connect_request {
+    Adapter *adapter; // Borrowed
+    Device *device; // Borrowed
+    guint attempts;
+    guint timer;
+    ConnectPhase phase;
+} ConnectRequest;
+
 struct binc_adapter {
     const char *path; // Owned
     const char *address; // Owned
@@ -77,9 +104,15 @@ struct binc_adapter {
     gboolean discovering;
     DiscoveryState discovery_state;
     DiscoveryFilter discovery_filter;
+    guint discovery_min_interval_ms;
+    short discovery_rssi_delta;
+    GHashTable *discovery_report_state; // Owned, device path -> DiscoveryReportState
+    GPtrArray *discovery_pending; // Owned, devices are borrowed
+    guint discovery_flush_source;
 
     GDBusConnection *connection;  // Borrowed
     guint device_prop_changed;
+    guint characteristic_prop_changed;
     guint adapter_prop_changed;
     guint iface_added;
     guint iface_removed;
@@ -89,10 +122,24 @@ struct binc_adapter {
     AdapterDiscoveryStateChangeCallback discoveryStateCallback;
     AdapterPoweredStateChangeCallback poweredStateCallback;
     RemoteCentralConnectionStateCallback centralStateCallback;
+    AdapterStatsCallback statsCallback;
+    guint stats_timer;
     void *user_data; // Borrowed
+    CallbackExecutor *callback_executor; // Borrowed
+    guint device_cache_limit;
+    GQueue *connect_queue; // Owned, devices are borrowed
+    GHashTable *connect_requests; // Owned, device path -> ConnectRequest
+    guint connects_attempting;
+    guint connect_max_in_flight;
+    guint connect_timeout_ms;
+    guint connect_max_retries;
     GHashTable *devices_cache; // Owned
+    ObjectManagerCache *object_manager_cache; // Shared
 
     Advertisement *advertisement; // Borrowed
+    GPtrArray *adv_rotation; // Borrowed, advertisements are borrowed
+    guint adv_rotation_index;
+    guint adv_rotation_timer;
 };
 
 static void remove_signal_subscribers(Adapter *adapter) {
@@ -100,8 +147,10 @@ static void remove_signal_subscribers(Adapter *adapter) {
 
     g_dbus_connection_signal_unsubscribe(adapter->connection, adapter->device_prop_changed);
     adapter->device_prop_changed = 0;
+    g_dbus_connection_signal_unsubscribe(adapter->connection, adapter->characteristic_prop_changed);
+    adapter->characteristic_prop_changed = 0;
     g_dbus_connection_signal_unsubscribe(adapter->connection, adapter->adapter_prop_changed);
-    adapter->device_prop_changed = 0;
+    adapter->adapter_prop_changed = 0;
     g_dbus_connection_signal_unsubscribe(adapter->connection, adapter->iface_added);
     adapter->iface_added = 0;
     g_dbus_connection_signal_unsubscribe(adapter->connection, adapter->iface_removed);
@@ -132,11 +181,51 @@ void binc_adapter_free(Adapter *adapter) {
         adapter->discovery_filter.services = NULL;
     }
 
+    if (adapter->discovery_flush_source != 0) {
+        binc_source_remove(adapter->discovery_flush_source);
+        adapter->discovery_flush_source = 0;
+    }
+
+    if (adapter->stats_timer != 0) {
+        binc_source_remove(adapter->stats_timer);
+        adapter->stats_timer = 0;
+    }
+
+    if (adapter->adv_rotation_timer != 0) {
+        binc_source_remove(adapter->adv_rotation_timer);
+        adapter->adv_rotation_timer = 0;
+    }
+
+    if (adapter->discovery_pending != NULL) {
+        g_ptr_array_free(adapter->discovery_pending, TRUE);
+        adapter->discovery_pending = NULL;
+    }
+
+    if (adapter->discovery_report_state != NULL) {
+        g_hash_table_destroy(adapter->discovery_report_state);
+        adapter->discovery_report_state = NULL;
+    }
+
+    if (adapter->connect_requests != NULL) {
+        g_hash_table_destroy(adapter->connect_requests);
+        adapter->connect_requests = NULL;
+    }
+
+    if (adapter->connect_queue != NULL) {
+        g_queue_free(adapter->connect_queue);
+        adapter->connect_queue = NULL;
+    }
+
     if (adapter->devices_cache != NULL) {
         g_hash_table_destroy(adapter->devices_cache);
         adapter->devices_cache = NULL;
     }
 
+    if (adapter->object_manager_cache != NULL) {
+        binc_object_manager_cache_unref(adapter->object_manager_cache);
+        adapter->object_manager_cache = NULL;
+    }
+
     g_free((char *) adapter->path);
     adapter->path = NULL;
 
@@ -169,6 +258,7 @@ static void binc_internal_adapter_call_method(Adapter *adapter, const char *meth
     g_assert(adapter != NULL);
     g_assert(method != NULL);
 
+    binc_internal_stats_add(BINC_STATS_DBUS_CALLS, 1);
     g_dbus_connection_call(adapter->connection,
                            BLUEZ_DBUS,
                            adapter->path,
@@ -267,6 +357,20 @@ static gboolean matches_discovery_filter(Adapter *adapter, Device *device) {
     return TRUE;
 }
 
+typedef struct binc_discovery_result_task {
+    Adapter *adapter; // Borrowed
+    Device *device; // Borrowed
+} DiscoveryResultTask;
+
+static void binc_internal_discovery_result_task(gpointer task_data) {
+    DiscoveryResultTask *task = (DiscoveryResultTask *) task_data;
+    // The callback may have been removed since this task was queued
+    if (task->adapter->discoveryResultCallback != NULL) {
+        task->adapter->discoveryResultCallback(task->adapter, task->device);
+    }
+    g_free(task);
+}
+
 static void deliver_discovery_result(Adapter *adapter, Device *device) {
     g_assert(adapter != NULL);
     g_assert(device != NULL);
@@ -276,11 +380,82 @@ static void deliver_discovery_result(Adapter *adapter, Device *device) {
         if (!matches_discovery_filter(adapter, device)) return;
 
         if (adapter->discoveryResultCallback != NULL) {
-            adapter->discoveryResultCallback(adapter, device);
+            binc_internal_stats_add(BINC_STATS_DISCOVERY_RESULTS, 1);
+            if (adapter->callback_executor != NULL) {
+                DiscoveryResultTask *task = g_new0(DiscoveryResultTask, 1);
+                task->adapter = adapter;
+                task->device = device;
+                binc_callback_executor_submit(adapter->callback_executor, binc_device_get_path(device),
+                                              binc_internal_discovery_result_task, task);
+            } else {
+                adapter->discoveryResultCallback(adapter, device);
+            }
         }
     }
 }
 
+static gboolean binc_internal_flush_discovery_queue(gpointer user_data) {
+    Adapter *adapter = (Adapter *) user_data;
+    g_assert(adapter != NULL);
+
+    adapter->discovery_flush_source = 0;
+    for (guint i = 0; i < adapter->discovery_pending->len; i++) {
+        deliver_discovery_result(adapter, g_ptr_array_index(adapter->discovery_pending, i));
+    }
+    g_ptr_array_set_size(adapter->discovery_pending, 0);
+    return G_SOURCE_REMOVE;
+}
+
+/*
+ * Rate limit and coalesce discovery results. When coalescing is enabled a
+ * device is only reported when it is seen for the first time, when it comes
+ * with new manufacturer/service data or when its RSSI moved more than the
+ * configured delta, and never more often than the minimum report interval.
+ * Reports are batched and delivered once per mainloop iteration.
+ */
+static void binc_internal_queue_discovery_result(Adapter *adapter, Device *device, gboolean has_new_data) {
+    g_assert(adapter != NULL);
+    g_assert(device != NULL);
+
+    if (adapter->discovery_min_interval_ms == 0) {
+        deliver_discovery_result(adapter, device);
+        return;
+    }
+
+    const char *path = binc_device_get_path(device);
+    gint64 now = g_get_monotonic_time() / 1000;
+    DiscoveryReportState *state = g_hash_table_lookup(adapter->discovery_report_state, path);
+    if (state != NULL) {
+        if ((now - state->last_report_millis) < (gint64) adapter->discovery_min_interval_ms) return;
+
+        short rssi_delta = (short) ABS(binc_device_get_rssi(device) - state->last_rssi);
+        if (!has_new_data && rssi_delta < adapter->discovery_rssi_delta) return;
+    } else {
+        state = g_new0(DiscoveryReportState, 1);
+        g_hash_table_insert(adapter->discovery_report_state, g_strdup(path), state);
+    }
+
+    state->last_report_millis = now;
+    state->last_rssi = binc_device_get_rssi(device);
+
+    if (!g_ptr_array_find(adapter->discovery_pending, device, NULL)) {
+        g_ptr_array_add(adapter->discovery_pending, device);
+    }
+    if (adapter->discovery_flush_source == 0) {
+        adapter->discovery_flush_source = binc_idle_add(binc_internal_flush_discovery_queue, adapter);
+    }
+}
+
+static void binc_internal_connect_manager_forget(Adapter *adapter, Device *device);
+
+static void binc_internal_discovery_forget(Adapter *adapter, Device *device) {
+    g_assert(adapter != NULL);
+    g_assert(device != NULL);
+
+    g_hash_table_remove(adapter->discovery_report_state, binc_device_get_path(device));
+    g_ptr_array_remove(adapter->discovery_pending, device);
+}
+
 static void deliver_device_removal(Adapter *adapter, Device *device) {
    g_assert(adapter != NULL);
    g_assert(device != NULL);
@@ -310,8 +485,11 @@ static void binc_internal_device_disappeared(__attribute__((unused)) GDBusConnec
     while (g_variant_iter_loop(interfaces, "s", &interface_name)) {
         if (g_str_equal(interface_name, INTERFACE_DEVICE)) {
             log_debug(TAG, "Device %s removed", object);
-            if (g_hash_table_lookup(adapter->devices_cache, object) != NULL) {
-  	        deliver_device_removal(adapter, g_hash_table_lookup(adapter->devices_cache, object));
+            Device *device = g_hash_table_lookup(adapter->devices_cache, object);
+            if (device != NULL) {
+                binc_internal_discovery_forget(adapter, device);
+                binc_internal_connect_manager_forget(adapter, device);
+                deliver_device_removal(adapter, device);
                 g_hash_table_remove(adapter->devices_cache, object);
             }
         }
@@ -321,6 +499,50 @@ static void binc_internal_device_disappeared(__attribute__((unused)) GDBusConnec
         g_variant_iter_free(interfaces);
 }
 
+/*
+ * Keep the devices cache bounded by evicting the least recently seen devices
+ * once the configured limit is exceeded. Only disconnected, unbonded devices
+ * that are not acting as central are candidates; the regular device removal
+ * callback fires for every evicted device. 'just_added' (may be NULL) is the
+ * device whose insertion triggered the eviction: it is never a candidate, as
+ * its caller keeps using it.
+ */
+static void binc_internal_evict_devices_if_needed(Adapter *adapter, const Device *just_added) {
+    g_assert(adapter != NULL);
+
+    if (adapter->device_cache_limit == 0) return;
+
+    while (g_hash_table_size(adapter->devices_cache) > adapter->device_cache_limit) {
+        GHashTableIter iter;
+        gpointer key;
+        Device *oldest = NULL;
+
+        g_hash_table_iter_init(&iter, adapter->devices_cache);
+        gpointer value;
+        while (g_hash_table_iter_next(&iter, &key, &value)) {
+            Device *device = (Device *) value;
+            if (device == just_added) continue;
+            if (binc_device_get_connection_state(device) != BINC_DISCONNECTED) continue;
+            if (binc_device_get_bonding_state(device) != BINC_BOND_NONE) continue;
+            if (binc_device_is_central(device)) continue;
+
+            if (oldest == NULL ||
+                binc_internal_device_get_last_seen(device) < binc_internal_device_get_last_seen(oldest)) {
+                oldest = device;
+            }
+        }
+
+        // Nothing evictable, allow the cache to grow beyond the limit
+        if (oldest == NULL) return;
+
+        log_debug(TAG, "evicting %s from device cache", binc_device_get_path(oldest));
+        binc_internal_discovery_forget(adapter, oldest);
+        binc_internal_connect_manager_forget(adapter, oldest);
+        deliver_device_removal(adapter, oldest);
+        g_hash_table_remove(adapter->devices_cache, binc_device_get_path(oldest));
+    }
+}
+
 static void binc_internal_device_appeared(__attribute__((unused)) GDBusConnection *conn,
                                           __attribute__((unused)) const gchar *sender_name,
                                           __attribute__((unused)) const gchar *object_path,
@@ -354,9 +576,10 @@ static void binc_internal_device_appeared(__attribute__((unused)) GDBusConnectio
             g_hash_table_insert(adapter->devices_cache,
                                 g_strdup(binc_device_get_path(device)),
                                 device);
+            binc_internal_evict_devices_if_needed(adapter, device);
 
             if (adapter->discovery_state == BINC_DISCOVERY_STARTED && binc_device_get_connection_state(device) == BINC_DISCONNECTED) {
-                deliver_discovery_result(adapter, device);
+                binc_internal_queue_discovery_result(adapter, device, TRUE);
             }
 
             if (binc_device_get_connection_state(device) == BINC_CONNECTED &&
@@ -423,6 +646,145 @@ static void binc_internal_device_getall_properties(Adapter *adapter, Device *dev
 }
 
 
+static void binc_internal_pump_connect_queue(Adapter *adapter);
+
+static void binc_internal_connect_request_free(ConnectRequest *request) {
+    if (request->timer != 0) {
+        binc_source_remove(request->timer);
+        request->timer = 0;
+    }
+    g_free(request);
+}
+
+static gboolean binc_internal_connect_timeout(gpointer user_data);
+
+static gboolean binc_internal_connect_retry(gpointer user_data) {
+    ConnectRequest *request = (ConnectRequest *) user_data;
+    g_assert(request != NULL);
+
+    Adapter *adapter = request->adapter;
+    request->phase = CONNECT_ATTEMPTING;
+    request->attempts++;
+    request->timer = binc_timeout_add(adapter->connect_timeout_ms, binc_internal_connect_timeout, request);
+    adapter->connects_attempting++;
+
+    log_debug(TAG, "retrying connect to %s (attempt %u)", binc_device_get_path(request->device), request->attempts);
+    binc_device_connect(request->device);
+    return G_SOURCE_REMOVE;
+}
+
+static void binc_internal_connect_attempt_failed(ConnectRequest *request) {
+    Adapter *adapter = request->adapter;
+
+    if (request->timer != 0) {
+        binc_source_remove(request->timer);
+        request->timer = 0;
+    }
+    g_assert(adapter->connects_attempting > 0);
+    adapter->connects_attempting--;
+
+    if (request->attempts <= adapter->connect_max_retries) {
+        // Back off a bit longer for every failed attempt
+        request->phase = CONNECT_WAITING_RETRY;
+        request->timer = binc_timeout_add(request->attempts * CONNECT_RETRY_BACKOFF_MS,
+                                       binc_internal_connect_retry, request);
+    } else {
+        log_debug(TAG, "giving up on %s after %u attempts", binc_device_get_path(request->device),
+                  request->attempts);
+        g_hash_table_remove(adapter->connect_requests, binc_device_get_path(request->device));
+    }
+    binc_internal_pump_connect_queue(adapter);
+}
+
+static gboolean binc_internal_connect_timeout(gpointer user_data) {
+    ConnectRequest *request = (ConnectRequest *) user_data;
+    g_assert(request != NULL);
+
+    request->timer = 0;
+    log_debug(TAG, "connect to %s timed out", binc_device_get_path(request->device));
+    binc_internal_connect_attempt_failed(request);
+    return G_SOURCE_REMOVE;
+}
+
+static void binc_internal_pump_connect_queue(Adapter *adapter) {
+    g_assert(adapter != NULL);
+
+    while (adapter->connects_attempting < adapter->connect_max_in_flight &&
+           !g_queue_is_empty(adapter->connect_queue)) {
+        Device *device = g_queue_pop_head(adapter->connect_queue);
+        if (binc_device_get_connection_state(device) != BINC_DISCONNECTED) continue;
+
+        ConnectRequest *request = g_new0(ConnectRequest, 1);
+        request->adapter = adapter;
+        request->device = device;
+        request->attempts = 1;
+        request->phase = CONNECT_ATTEMPTING;
+        request->timer = binc_timeout_add(adapter->connect_timeout_ms, binc_internal_connect_timeout, request);
+        g_hash_table_insert(adapter->connect_requests, g_strdup(binc_device_get_path(device)), request);
+        adapter->connects_attempting++;
+
+        binc_device_connect(device);
+    }
+}
+
+// Advance the connect pipeline when a tracked device reaches a settled state
+static void binc_internal_connect_manager_on_state(Adapter *adapter, Device *device) {
+    g_assert(adapter != NULL);
+    g_assert(device != NULL);
+
+    ConnectRequest *request = g_hash_table_lookup(adapter->connect_requests, binc_device_get_path(device));
+    if (request == NULL || request->phase != CONNECT_ATTEMPTING) return;
+
+    ConnectionState state = binc_device_get_connection_state(device);
+    if (state == BINC_CONNECTED) {
+        g_assert(adapter->connects_attempting > 0);
+        adapter->connects_attempting--;
+        g_hash_table_remove(adapter->connect_requests, binc_device_get_path(device));
+        binc_internal_pump_connect_queue(adapter);
+    } else if (state == BINC_DISCONNECTED) {
+        binc_internal_connect_attempt_failed(request);
+    }
+}
+
+static void binc_internal_connect_manager_forget(Adapter *adapter, Device *device) {
+    g_assert(adapter != NULL);
+    g_assert(device != NULL);
+
+    ConnectRequest *request = g_hash_table_lookup(adapter->connect_requests, binc_device_get_path(device));
+    if (request != NULL && request->phase == CONNECT_ATTEMPTING) {
+        g_assert(adapter->connects_attempting > 0);
+        adapter->connects_attempting--;
+    }
+    g_hash_table_remove(adapter->connect_requests, binc_device_get_path(device));
+    g_queue_remove(adapter->connect_queue, device);
+}
+
+void binc_adapter_connect_all(Adapter *adapter, GPtrArray *devices, guint max_in_flight) {
+    g_assert(adapter != NULL);
+    g_assert(devices != NULL);
+
+    adapter->connect_max_in_flight = max_in_flight > 0 ? max_in_flight : DEFAULT_CONNECT_MAX_IN_FLIGHT;
+
+    for (guint i = 0; i < devices->len; i++) {
+        Device *device = g_ptr_array_index(devices, i);
+        if (binc_device_get_connection_state(device) != BINC_DISCONNECTED) continue;
+        if (g_hash_table_lookup(adapter->connect_requests, binc_device_get_path(device)) != NULL) continue;
+        if (g_queue_find(adapter->connect_queue, device) != NULL) continue;
+
+        g_queue_push_tail(adapter->connect_queue, device);
+    }
+
+    binc_internal_pump_connect_queue(adapter);
+}
+
+void binc_adapter_set_connect_timeout(Adapter *adapter, guint timeout_ms, guint max_retries) {
+    g_assert(adapter != NULL);
+    g_assert(timeout_ms > 0);
+
+    adapter->connect_timeout_ms = timeout_ms;
+    adapter->connect_max_retries = max_retries;
+}
+
 static void binc_internal_device_changed(__attribute__((unused)) GDBusConnection *conn,
                                          __attribute__((unused)) const gchar *sender,
                                          const gchar *path,
@@ -444,22 +806,26 @@ static void binc_internal_device_changed(__attribute__((unused)) GDBusConnection
     if (device == NULL) {
         device = binc_device_create(path, adapter);
         g_hash_table_insert(adapter->devices_cache, g_strdup(binc_device_get_path(device)), device);
+        binc_internal_evict_devices_if_needed(adapter, device);
         binc_internal_device_getall_properties(adapter, device);
     } else {
         gboolean isDiscoveryResult = FALSE;
+        gboolean hasNewData = FALSE;
         ConnectionState oldState = binc_device_get_connection_state(device);
         g_assert(g_str_equal(g_variant_get_type_string(parameters), "(sa{sv}as)"));
         g_variant_get(parameters, "(&sa{sv}as)", &iface, &properties_changed, &properties_invalidated);
         while (g_variant_iter_loop(properties_changed, "{&sv}", &property_name, &property_value)) {
             binc_internal_device_update_property(device, property_name, property_value);
-            if (g_str_equal(property_name, DEVICE_PROPERTY_RSSI) ||
-                g_str_equal(property_name, DEVICE_PROPERTY_MANUFACTURER_DATA) ||
-                g_str_equal(property_name, DEVICE_PROPERTY_SERVICE_DATA)) {
+            if (g_str_equal(property_name, DEVICE_PROPERTY_RSSI)) {
                 isDiscoveryResult = TRUE;
+            } else if (g_str_equal(property_name, DEVICE_PROPERTY_MANUFACTURER_DATA) ||
+                       g_str_equal(property_name, DEVICE_PROPERTY_SERVICE_DATA)) {
+                isDiscoveryResult = TRUE;
+                hasNewData = TRUE;
             }
         }
         if (adapter->discovery_state == BINC_DISCOVERY_STARTED && isDiscoveryResult) {
-            deliver_discovery_result(adapter, device);
+            binc_internal_queue_discovery_result(adapter, device, hasNewData);
         }
 
         if (binc_device_get_bonding_state(device) == BINC_BONDED && binc_device_get_rssi(device) == -255) {
@@ -474,6 +840,10 @@ static void binc_internal_device_changed(__attribute__((unused)) GDBusConnection
                 }
             }
         }
+
+        // Let the device handle connection/bonding/service-discovery logic
+        binc_internal_device_handle_properties_changed(device, parameters);
+        binc_internal_connect_manager_on_state(adapter, device);
     }
 
     if (properties_changed != NULL)
@@ -483,6 +853,44 @@ static void binc_internal_device_changed(__attribute__((unused)) GDBusConnection
         g_variant_iter_free(properties_invalidated);
 }
 
+/*
+ * All characteristics share this single adapter-wide subscription so that
+ * connecting to a device does not register one bus match rule per
+ * characteristic. The signal is dispatched internally via the device and
+ * characteristic hash tables, keyed by object path.
+ */
+static void binc_internal_characteristic_changed(__attribute__((unused)) GDBusConnection *conn,
+                                                 __attribute__((unused)) const gchar *sender,
+                                                 const gchar *path,
+                                                 __attribute__((unused)) const gchar *interface,
+                                                 __attribute__((unused)) const gchar *signal,
+                                                 GVariant *parameters,
+                                                 void *user_data) {
+
+    Adapter *adapter = (Adapter *) user_data;
+    g_assert(adapter != NULL);
+
+    if (!g_str_has_prefix(path, adapter->path)) return;
+
+    // The characteristic path starts with the device path, so cut at the service segment
+    const char *service_part = strstr(path, "/service");
+    if (service_part == NULL) return;
+
+    char device_path[128];
+    gsize length = (gsize) (service_part - path);
+    if (length >= sizeof(device_path)) return;
+    memcpy(device_path, path, length);
+    device_path[length] = 0;
+
+    Device *device = g_hash_table_lookup(adapter->devices_cache, device_path);
+    if (device == NULL) return;
+
+    Characteristic *characteristic = binc_internal_device_lookup_characteristic(device, path);
+    if (characteristic == NULL) return;
+
+    binc_internal_characteristic_handle_properties_changed(characteristic, parameters);
+}
+
 static void setup_signal_subscribers(Adapter *adapter) {
     adapter->device_prop_changed = g_dbus_connection_signal_subscribe(adapter->connection,
                                                                       BLUEZ_DBUS,
@@ -495,6 +903,17 @@ static void setup_signal_subscribers(Adapter *adapter) {
                                                                       adapter,
                                                                       NULL);
 
+    adapter->characteristic_prop_changed = g_dbus_connection_signal_subscribe(adapter->connection,
+                                                                              BLUEZ_DBUS,
+                                                                              INTERFACE_PROPERTIES,
+                                                                              SIGNAL_PROPERTIES_CHANGED,
+                                                                              NULL,
+                                                                              INTERFACE_CHARACTERISTIC,
+                                                                              G_DBUS_SIGNAL_FLAGS_NONE,
+                                                                              binc_internal_characteristic_changed,
+                                                                              adapter,
+                                                                              NULL);
+
     adapter->adapter_prop_changed = g_dbus_connection_signal_subscribe(adapter->connection,
                                                                        BLUEZ_DBUS,
                                                                        INTERFACE_PROPERTIES,
@@ -551,6 +970,15 @@ static Adapter *binc_adapter_create(GDBusConnection *connection, const char *pat
     adapter->discovery_filter.rssi = -255;
     adapter->devices_cache = g_hash_table_new_full(g_str_hash, g_str_equal,
                                                    g_free, (GDestroyNotify) binc_device_free);
+    adapter->discovery_report_state = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, g_free);
+    adapter->discovery_pending = g_ptr_array_new();
+    adapter->connect_queue = g_queue_new();
+    adapter->connect_requests = g_hash_table_new_full(g_str_hash, g_str_equal, g_free,
+                                                      (GDestroyNotify) binc_internal_connect_request_free);
+    adapter->connect_max_in_flight = DEFAULT_CONNECT_MAX_IN_FLIGHT;
+    adapter->connect_timeout_ms = DEFAULT_CONNECT_TIMEOUT_MS;
+    adapter->connect_max_retries = DEFAULT_CONNECT_MAX_RETRIES;
+    adapter->object_manager_cache = binc_object_manager_cache_get(connection);
     adapter->user_data = NULL;
     setup_signal_subscribers(adapter);
     return adapter;
@@ -571,24 +999,8 @@ static Adapter *binc_internal_get_adapter_by_path(GPtrArray *adapters, const cha
     return NULL;
 }
 
-GPtrArray *binc_adapter_find_all(GDBusConnection *dbusConnection) {
-    g_assert(dbusConnection != NULL);
-
+static GPtrArray *binc_internal_adapters_from_managed_objects(GDBusConnection *dbusConnection, GVariant *result) {
     GPtrArray *binc_adapters = g_ptr_array_new();
-    log_debug(TAG, "finding adapters");
-
-    GError *error = NULL;
-    GVariant *result = g_dbus_connection_call_sync(dbusConnection,
-                                                   BLUEZ_DBUS,
-                                                   "/",
-                                                   INTERFACE_OBJECT_MANAGER,
-                                                   "GetManagedObjects",
-                                                   NULL,
-                                                   G_VARIANT_TYPE("(a{oa{sa{sv}}})"),
-                                                   G_DBUS_CALL_FLAGS_NONE,
-                                                   -1,
-                                                   NULL,
-                                                   &error);
 
     if (result) {
         GVariantIter *iter;
@@ -645,13 +1057,121 @@ GPtrArray *binc_adapter_find_all(GDBusConnection *dbusConnection) {
         g_variant_unref(result);
     }
 
+    log_debug(TAG, "found %d adapter%s", binc_adapters->len, binc_adapters->len > 1 ? "s" : "");
+    return binc_adapters;
+}
+
+GPtrArray *binc_adapter_find_all(GDBusConnection *dbusConnection) {
+    g_assert(dbusConnection != NULL);
+
+    log_debug(TAG, "finding adapters");
+
+    GError *error = NULL;
+    GVariant *result = g_dbus_connection_call_sync(dbusConnection,
+                                                   BLUEZ_DBUS,
+                                                   "/",
+                                                   INTERFACE_OBJECT_MANAGER,
+                                                   "GetManagedObjects",
+                                                   NULL,
+                                                   G_VARIANT_TYPE("(a{oa{sa{sv}}})"),
+                                                   G_DBUS_CALL_FLAGS_NONE,
+                                                   -1,
+                                                   NULL,
+                                                   &error);
+
     if (error != NULL) {
         log_error(TAG, "Error GetManagedObjects: %s", error->message);
         g_clear_error(&error);
     }
 
-    log_debug(TAG, "found %d adapter%s", binc_adapters->len, binc_adapters->len > 1 ? "s" : "");
-    return binc_adapters;
+    return binc_internal_adapters_from_managed_objects(dbusConnection, result);
+}
+
+typedef struct {
+    GDBusConnection *connection; // Borrowed
+    AdapterFindCallback callback;
+    gpointer user_data; // Borrowed
+} FindAdaptersData;
+
+static void binc_internal_find_adapters_cb(__attribute__((unused)) GObject *source_object,
+                                           GAsyncResult *res,
+                                           gpointer user_data) {
+
+    FindAdaptersData *data = (FindAdaptersData *) user_data;
+    g_assert(data != NULL);
+
+    GError *error = NULL;
+    GVariant *result = g_dbus_connection_call_finish(data->connection, res, &error);
+
+    if (error != NULL) {
+        log_error(TAG, "Error GetManagedObjects: %s", error->message);
+        g_clear_error(&error);
+    }
+
+    GPtrArray *adapters = binc_internal_adapters_from_managed_objects(data->connection, result);
+    data->callback(adapters, data->user_data);
+    g_free(data);
+}
+
+void binc_adapter_find_all_async(GDBusConnection *dbusConnection, AdapterFindCallback callback, gpointer user_data) {
+    g_assert(dbusConnection != NULL);
+    g_assert(callback != NULL);
+
+    log_debug(TAG, "finding adapters");
+
+    FindAdaptersData *data = g_new0(FindAdaptersData, 1);
+    data->connection = dbusConnection;
+    data->callback = callback;
+    data->user_data = user_data;
+
+    g_dbus_connection_call(dbusConnection,
+                           BLUEZ_DBUS,
+                           "/",
+                           INTERFACE_OBJECT_MANAGER,
+                           "GetManagedObjects",
+                           NULL,
+                           G_VARIANT_TYPE("(a{oa{sa{sv}}})"),
+                           G_DBUS_CALL_FLAGS_NONE,
+                           -1,
+                           NULL,
+                           (GAsyncReadyCallback) binc_internal_find_adapters_cb,
+                           data);
+}
+
+typedef struct {
+    AdapterReadyCallback callback;
+    gpointer user_data; // Borrowed
+} DefaultAdapterData;
+
+static void binc_internal_default_adapter_found(GPtrArray *adapters, gpointer user_data) {
+    DefaultAdapterData *data = (DefaultAdapterData *) user_data;
+    g_assert(data != NULL);
+
+    Adapter *adapter = NULL;
+    if (adapters->len > 0) {
+        // Choose the first one in the array, typically the 'hciX' with the highest X
+        adapter = g_ptr_array_index(adapters, 0);
+
+        // Free any other adapters we are not going to use
+        for (guint i = 1; i < adapters->len; i++) {
+            binc_adapter_free(g_ptr_array_index(adapters, i));
+        }
+    }
+    g_ptr_array_free(adapters, TRUE);
+
+    data->callback(adapter, data->user_data);
+    g_free(data);
+}
+
+void binc_adapter_get_default_async(GDBusConnection *dbusConnection, AdapterReadyCallback callback,
+                                    gpointer user_data) {
+    g_assert(dbusConnection != NULL);
+    g_assert(callback != NULL);
+
+    DefaultAdapterData *data = g_new0(DefaultAdapterData, 1);
+    data->callback = callback;
+    data->user_data = user_data;
+    binc_adapter_find_all_async(dbusConnection, binc_internal_default_adapter_found, data);
 }
 
 Adapter *binc_adapter_get_default(GDBusConnection *dbusConnection) {
@@ -854,6 +1374,21 @@ void binc_adapter_set_discovery_filter(Adapter *adapter, short rssi_threshold, c
     binc_internal_adapter_call_method(adapter, METHOD_SET_DISCOVERY_FILTER, g_variant_new_tuple(&filter, 1));
 }
 
+void binc_adapter_set_discovery_coalescing(Adapter *adapter, guint min_interval_ms, short rssi_delta) {
+    g_assert(adapter != NULL);
+    g_assert(rssi_delta >= 0);
+
+    adapter->discovery_min_interval_ms = min_interval_ms;
+    adapter->discovery_rssi_delta = rssi_delta;
+}
+
+void binc_adapter_set_device_cache_limit(Adapter *adapter, guint max_devices) {
+    g_assert(adapter != NULL);
+
+    adapter->device_cache_limit = max_devices;
+    binc_internal_evict_devices_if_needed(adapter, NULL);
+}
+
 static void binc_internal_set_property_cb(__attribute__((unused)) GObject *source_object,
                                           GAsyncResult *res,
                                           gpointer user_data) {
@@ -918,8 +1453,8 @@ void binc_adapter_discoverable_off(Adapter *adapter) {
 
 void binc_adapter_set_discovery_cb(Adapter *adapter, AdapterDiscoveryResultCallback callback) {
     g_assert(adapter != NULL);
-    g_assert(callback != NULL);
 
+    // NULL removes the callback
     adapter->discoveryResultCallback = callback;
 }
 
@@ -986,6 +1521,11 @@ GDBusConnection *binc_adapter_get_dbus_connection(const Adapter *adapter) {
     return adapter->connection;
 }
 
+ObjectManagerCache *binc_adapter_get_object_manager_cache(const Adapter *adapter) {
+    g_assert(adapter != NULL);
+    return adapter->object_manager_cache;
+}
+
 const char *binc_adapter_get_discovery_state_name(const Adapter *adapter) {
     g_assert(adapter != NULL);
     return discovery_state_names[adapter->discovery_state];
@@ -1011,11 +1551,7 @@ static void binc_internal_start_advertising_cb(__attribute__((unused)) GObject *
     }
 }
 
-void binc_adapter_start_advertising(Adapter *adapter, Advertisement *advertisement) {
-    g_assert(adapter != NULL);
-    g_assert(advertisement != NULL);
-
-    adapter->advertisement = advertisement;
+static void binc_internal_register_advertisement(Adapter *adapter, Advertisement *advertisement) {
     binc_advertisement_register(advertisement, adapter);
 
     g_dbus_connection_call(binc_adapter_get_dbus_connection(adapter),
@@ -1031,15 +1567,28 @@ void binc_adapter_start_advertising(Adapter *adapter, Advertisement *advertiseme
                            (GAsyncReadyCallback) binc_internal_start_advertising_cb, adapter);
 }
 
+void binc_adapter_start_advertising(Adapter *adapter, Advertisement *advertisement) {
+    g_assert(adapter != NULL);
+    g_assert(advertisement != NULL);
+
+    adapter->advertisement = advertisement;
+    binc_internal_register_advertisement(adapter, advertisement);
+}
+
+typedef struct binc_stop_advertising_data {
+    Adapter *adapter; // Borrowed
+    Advertisement *advertisement; // Borrowed
+} StopAdvertisingData;
+
 static void binc_internal_stop_advertising_cb(__attribute__((unused)) GObject *source_object,
                                               GAsyncResult *res,
                                               gpointer user_data) {
 
-    Adapter *adapter = (Adapter *) user_data;
-    g_assert(adapter != NULL);
+    StopAdvertisingData *data = (StopAdvertisingData *) user_data;
+    g_assert(data != NULL);
 
     GError *error = NULL;
-    GVariant *value = g_dbus_connection_call_finish(adapter->connection, res, &error);
+    GVariant *value = g_dbus_connection_call_finish(data->adapter->connection, res, &error);
     if (value != NULL) {
         g_variant_unref(value);
     }
@@ -1048,15 +1597,16 @@ static void binc_internal_stop_advertising_cb(__attribute__((unused)) GObject *s
         log_debug(TAG, "failed to unregister advertisement (error %d: %s)", error->code, error->message);
         g_clear_error(&error);
     } else {
-        binc_advertisement_unregister(adapter->advertisement, adapter);
+        binc_advertisement_unregister(data->advertisement, data->adapter);
         log_debug(TAG, "stopped advertising");
     }
-
+    g_free(data);
 }
 
-void binc_adapter_stop_advertising(Adapter *adapter, Advertisement *advertisement) {
-    g_assert(adapter != NULL);
-    g_assert(advertisement != NULL);
+static void binc_internal_unregister_advertisement(Adapter *adapter, Advertisement *advertisement) {
+    StopAdvertisingData *data = g_new0(StopAdvertisingData, 1);
+    data->adapter = adapter;
+    data->advertisement = advertisement;
 
     g_dbus_connection_call(binc_adapter_get_dbus_connection(adapter),
                            "org.bluez",
@@ -1068,7 +1618,67 @@ void binc_adapter_stop_advertising(Adapter *adapter, Advertisement *advertisemen
                            G_DBUS_CALL_FLAGS_NONE,
                            -1,
                            NULL,
-                           (GAsyncReadyCallback) binc_internal_stop_advertising_cb, adapter);
+                           (GAsyncReadyCallback) binc_internal_stop_advertising_cb, data);
+}
+
+void binc_adapter_stop_advertising(Adapter *adapter, Advertisement *advertisement) {
+    g_assert(adapter != NULL);
+    g_assert(advertisement != NULL);
+
+    // Stopping the rotation already takes the frame on air off the air
+    gboolean is_rotation_frame = adapter->adv_rotation != NULL &&
+                                 g_ptr_array_find(adapter->adv_rotation, advertisement, NULL);
+    binc_adapter_stop_advertising_rotation(adapter);
+    if (!is_rotation_frame) {
+        binc_internal_unregister_advertisement(adapter, advertisement);
+    }
+}
+
+static gboolean binc_internal_adv_rotation_timer(gpointer user_data) {
+    Adapter *adapter = (Adapter *) user_data;
+    g_assert(adapter != NULL);
+
+    Advertisement *previous = g_ptr_array_index(adapter->adv_rotation, adapter->adv_rotation_index);
+    adapter->adv_rotation_index = (adapter->adv_rotation_index + 1) % adapter->adv_rotation->len;
+    Advertisement *next = g_ptr_array_index(adapter->adv_rotation, adapter->adv_rotation_index);
+
+    // Register the incoming frame before unregistering the outgoing one so
+    // the controller keeps advertising throughout the swap
+    adapter->advertisement = next;
+    binc_internal_register_advertisement(adapter, next);
+    binc_internal_unregister_advertisement(adapter, previous);
+    return TRUE;
+}
+
+void binc_adapter_start_advertising_rotation(Adapter *adapter, GPtrArray *advertisements, guint interval_ms) {
+    g_assert(adapter != NULL);
+    g_assert(advertisements != NULL);
+    g_assert(advertisements->len > 0);
+    g_assert(interval_ms > 0);
+
+    binc_adapter_stop_advertising_rotation(adapter);
+
+    adapter->adv_rotation = advertisements;
+    adapter->adv_rotation_index = 0;
+    binc_adapter_start_advertising(adapter, g_ptr_array_index(advertisements, 0));
+    if (advertisements->len > 1) {
+        adapter->adv_rotation_timer = binc_timeout_add(interval_ms, binc_internal_adv_rotation_timer, adapter);
+    }
+}
+
+void binc_adapter_stop_advertising_rotation(Adapter *adapter) {
+    g_assert(adapter != NULL);
+
+    if (adapter->adv_rotation_timer != 0) {
+        binc_source_remove(adapter->adv_rotation_timer);
+        adapter->adv_rotation_timer = 0;
+    }
+    if (adapter->adv_rotation != NULL && adapter->advertisement != NULL) {
+        binc_internal_unregister_advertisement(adapter, adapter->advertisement);
+        adapter->advertisement = NULL;
+    }
+    adapter->adv_rotation = NULL;
+    adapter->adv_rotation_index = 0;
 }
 
 static void binc_internal_register_appl_cb(__attribute__((unused)) GObject *source_object,
@@ -1162,3 +1772,46 @@ void *binc_adapter_get_user_data(const Adapter *adapter) {
     g_assert(adapter != NULL);
     return adapter->user_data;
 }
+
+void binc_adapter_get_stats(const Adapter *adapter, Stats *stats) {
+    g_assert(adapter != NULL);
+    g_assert(stats != NULL);
+
+    binc_internal_stats_snapshot(stats);
+    stats->devices_cached = g_hash_table_size(adapter->devices_cache);
+    stats->connect_queue_depth = g_queue_get_length(adapter->connect_queue);
+}
+
+static gboolean binc_internal_stats_timer(gpointer user_data) {
+    Adapter *adapter = (Adapter *) user_data;
+    g_assert(adapter != NULL);
+
+    Stats stats;
+    binc_adapter_get_stats(adapter, &stats);
+    adapter->statsCallback(adapter, &stats);
+    return TRUE;
+}
+
+void binc_adapter_set_stats_cb(Adapter *adapter, AdapterStatsCallback callback, guint interval_ms) {
+    g_assert(adapter != NULL);
+
+    if (adapter->stats_timer != 0) {
+        binc_source_remove(adapter->stats_timer);
+        adapter->stats_timer = 0;
+    }
+
+    adapter->statsCallback = callback;
+    if (callback != NULL && interval_ms > 0) {
+        adapter->stats_timer = binc_timeout_add(interval_ms, binc_internal_stats_timer, adapter);
+    }
+}
+
+void binc_adapter_set_callback_executor(Adapter *adapter, CallbackExecutor *executor) {
+    g_assert(adapter != NULL);
+    adapter->callback_executor = executor;
+}
+
+CallbackExecutor *binc_internal_adapter_get_callback_executor(const Adapter *adapter) {
+    g_assert(adapter != NULL);
+    return adapter->callback_executor;
+}
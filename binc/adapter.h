@@ -26,6 +26,7 @@
 
 #include <gio/gio.h>
 #include "forward_decl.h"
+#include "stats.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -45,12 +46,62 @@ typedef void (*AdapterPoweredStateChangeCallback)(Adapter *adapter, gboolean sta
 
 typedef void (*RemoteCentralConnectionStateCallback)(Adapter *adapter, Device *device);
 
+typedef void (*AdapterStatsCallback)(Adapter *adapter, const Stats *stats);
+
+typedef void (*AdapterFindCallback)(GPtrArray *adapters, gpointer user_data);
+
+typedef void (*AdapterReadyCallback)(Adapter *adapter, gpointer user_data);
+
+/**
+ * Get the default adapter.
+ *
+ * The adapter binds to the thread-default GMainContext of the calling thread:
+ * all signal subscriptions, async call completions, timers and callbacks run
+ * on whatever loop iterates that context. To isolate BLE traffic from other
+ * sources, run a dedicated thread that pushes its own context with
+ * g_main_context_push_thread_default(), creates the dbus connection and the
+ * adapter there and runs a GMainLoop on it; call into the library from other
+ * threads via g_main_context_invoke() on that context. The same applies to
+ * binc_adapter_get() and binc_adapter_find_all().
+ *
+ * @param dbusConnection the dbus connection
+ * @return the default adapter (caller owns it), or NULL when none was found
+ */
 Adapter *binc_adapter_get_default(GDBusConnection *dbusConnection);
 
 Adapter *binc_adapter_get(GDBusConnection *dbusConnection, const char *name);
 
 GPtrArray *binc_adapter_find_all(GDBusConnection *dbusConnection);
 
+/**
+ * Find all adapters without blocking.
+ *
+ * Does the same GetManagedObjects walk as binc_adapter_find_all() but
+ * asynchronously, so startup work can proceed while the call is in flight.
+ * The callback runs on the GMainLoop thread and receives an array it takes
+ * ownership of; on failure the array is empty. Unused adapters must be freed
+ * with binc_adapter_free() and the array with g_ptr_array_free().
+ *
+ * @param dbusConnection the dbus connection
+ * @param callback called with the adapters found
+ * @param user_data data to pass to the callback
+ */
+void binc_adapter_find_all_async(GDBusConnection *dbusConnection, AdapterFindCallback callback, gpointer user_data);
+
+/**
+ * Get the default adapter without blocking.
+ *
+ * Async variant of binc_adapter_get_default(); the callback runs on the
+ * GMainLoop thread and receives the adapter (caller takes ownership), or
+ * NULL when no adapter was found.
+ *
+ * @param dbusConnection the dbus connection
+ * @param callback called with the default adapter or NULL
+ * @param user_data data to pass to the callback
+ */
+void binc_adapter_get_default_async(GDBusConnection *dbusConnection, AdapterReadyCallback callback,
+                                    gpointer user_data);
+
 void binc_adapter_free(Adapter *adapter);
 
 void binc_adapter_start_discovery(Adapter *adapter);
@@ -59,6 +110,58 @@ void binc_adapter_stop_discovery(Adapter *adapter);
 
 void binc_adapter_set_discovery_filter(Adapter *adapter, short rssi_threshold, const GPtrArray *service_uuids, const char *pattern);
 
+/**
+ * Coalesce and rate limit discovery results.
+ *
+ * When enabled, a device is only reported when it is seen for the first time,
+ * when it advertises new manufacturer/service data or when its RSSI changed
+ * at least 'rssi_delta' since the last report, and at most once per
+ * 'min_interval_ms' per device. Reports are batched and delivered once per
+ * mainloop iteration.
+ *
+ * @param adapter the adapter
+ * @param min_interval_ms minimum interval between reports per device in milliseconds, 0 disables coalescing
+ * @param rssi_delta minimum RSSI change (dBm) to consider an advertisement a material change
+ */
+void binc_adapter_set_discovery_coalescing(Adapter *adapter, guint min_interval_ms, short rssi_delta);
+
+/**
+ * Bound the number of cached devices.
+ *
+ * When the cache exceeds 'max_devices', the least recently seen devices that
+ * are disconnected, unbonded and not acting as central are evicted and the
+ * device removal callback fires for each of them. Pass 0 for an unbounded
+ * cache (the default).
+ *
+ * @param adapter the adapter
+ * @param max_devices maximum number of devices to keep cached, 0 for unbounded
+ */
+void binc_adapter_set_device_cache_limit(Adapter *adapter, guint max_devices);
+
+/**
+ * Connect to a set of devices with a bounded number of connects in flight.
+ *
+ * Connects are pipelined: at most 'max_in_flight' attempts run concurrently
+ * and the next device is taken from the queue as soon as an attempt settles.
+ * Attempts that time out or fail are retried with backoff (see
+ * binc_adapter_set_connect_timeout). Results are reported through each
+ * device's ConnectionStateChangedCallback as usual.
+ *
+ * @param adapter the adapter
+ * @param devices devices to connect (borrowed, must belong to this adapter)
+ * @param max_in_flight maximum concurrent connect attempts, 0 for the default (4)
+ */
+void binc_adapter_connect_all(Adapter *adapter, GPtrArray *devices, guint max_in_flight);
+
+/**
+ * Configure the per-attempt timeout and retry count used by binc_adapter_connect_all.
+ *
+ * @param adapter the adapter
+ * @param timeout_ms per-attempt timeout in milliseconds (default 10000)
+ * @param max_retries number of retries after a failed or timed-out attempt (default 2)
+ */
+void binc_adapter_set_connect_timeout(Adapter *adapter, guint timeout_ms, guint max_retries);
+
 void binc_adapter_remove_device(Adapter *adapter, Device *device);
 
 GList *binc_adapter_get_devices(const Adapter *adapter);
@@ -97,20 +200,84 @@ void binc_adapter_set_discovery_state_cb(Adapter *adapter, AdapterDiscoveryState
 
 void binc_adapter_set_powered_state_cb(Adapter *adapter, AdapterPoweredStateChangeCallback callback);
 
+/**
+ * Take a snapshot of the library's counters and this adapter's gauges.
+ *
+ * Counters are only collected after binc_stats_set_enabled(TRUE).
+ *
+ * @param adapter the adapter
+ * @param stats the struct to fill
+ */
+void binc_adapter_get_stats(const Adapter *adapter, Stats *stats);
+
+/**
+ * Register a callback that receives a stats snapshot periodically.
+ *
+ * @param adapter the adapter
+ * @param callback the callback, or NULL to stop the periodic snapshots
+ * @param interval_ms interval between snapshots in milliseconds
+ */
+void binc_adapter_set_stats_cb(Adapter *adapter, AdapterStatsCallback callback, guint interval_ms);
+
 GDBusConnection *binc_adapter_get_dbus_connection(const Adapter *adapter);
 
+ObjectManagerCache *binc_adapter_get_object_manager_cache(const Adapter *adapter); // make this internal
+
 gboolean binc_adapter_is_discoverable(const Adapter *adapter);
 
 void binc_adapter_start_advertising(Adapter *adapter, Advertisement *advertisement);
 
 void binc_adapter_stop_advertising(Adapter *adapter, Advertisement *advertisement);
 
+/**
+ * Rotate the on-air data through a set of advertisement frames.
+ *
+ * Each frame is registered with bluetoothd as its own advertisement
+ * instance. The first frame goes on air immediately (a prior
+ * binc_adapter_start_advertising() is not needed); every 'interval_ms' the
+ * next frame is registered before the previous one is unregistered, so the
+ * controller keeps advertising throughout the swap. bluetoothd only reads an
+ * advertisement's properties at registration, so frames must be fully
+ * populated before the rotation starts. Swapping needs two free advertising
+ * instances on the controller (see LEAdvertisingManager1.SupportedInstances).
+ *
+ * @param adapter the adapter
+ * @param advertisements frames to rotate through (borrowed, must outlive the rotation)
+ * @param interval_ms time between frames in milliseconds, must be > 0
+ */
+void binc_adapter_start_advertising_rotation(Adapter *adapter, GPtrArray *advertisements, guint interval_ms);
+
+/**
+ * Stop rotating and unregister the frame currently on air.
+ */
+void binc_adapter_stop_advertising_rotation(Adapter *adapter);
+
 void binc_adapter_register_application(Adapter *adapter, Application *application);
 
 void binc_adapter_unregister_application(Adapter *adapter, Application *application);
 
 void binc_adapter_set_remote_central_cb(Adapter *adapter, RemoteCentralConnectionStateCallback callback);
 
+/**
+ * Dispatch callbacks on a worker pool instead of the GMainLoop thread.
+ *
+ * When an executor is set, discovery results and characteristic
+ * read/write/notify callbacks are handed to the executor's thread pool,
+ * keyed by device path so callbacks for the same device always run in
+ * order and never concurrently. Callbacks for different devices run in
+ * parallel. Pass NULL to go back to delivering callbacks on the
+ * GMainLoop thread (the default).
+ *
+ * Note: when using an executor, callbacks must not free the adapter or
+ * its devices; do that from the mainloop thread after freeing the executor.
+ *
+ * @param adapter the adapter
+ * @param executor the executor to use (borrowed), or NULL
+ */
+void binc_adapter_set_callback_executor(Adapter *adapter, CallbackExecutor *executor);
+
+CallbackExecutor *binc_internal_adapter_get_callback_executor(const Adapter *adapter); // make this internal
+
 void binc_adapter_set_user_data(Adapter *adapter, void *user_data);
 
 void *binc_adapter_get_user_data(const Adapter *adapter);
@@ -54,6 +54,26 @@ static void add_service_data(gpointer key, gpointer value, gpointer userdata) {
     g_variant_builder_add((GVariantBuilder *) userdata, "{sv}", (char *) key, byteArrayVariant);
 }
 
+static GVariant *binc_internal_manufacturer_data_variant(const Advertisement *advertisement) {
+    GVariantBuilder *builder = g_variant_builder_new(G_VARIANT_TYPE("a{qv}"));
+    if (advertisement->manufacturer_data != NULL && g_hash_table_size(advertisement->manufacturer_data) > 0) {
+        g_hash_table_foreach(advertisement->manufacturer_data, add_manufacturer_data, builder);
+    }
+    GVariant *result = g_variant_builder_end(builder);
+    g_variant_builder_unref(builder);
+    return result;
+}
+
+static GVariant *binc_internal_service_data_variant(const Advertisement *advertisement) {
+    GVariantBuilder *builder = g_variant_builder_new(G_VARIANT_TYPE("a{sv}"));
+    if (advertisement->service_data != NULL && g_hash_table_size(advertisement->service_data) > 0) {
+        g_hash_table_foreach(advertisement->service_data, add_service_data, builder);
+    }
+    GVariant *result = g_variant_builder_end(builder);
+    g_variant_builder_unref(builder);
+    return result;
+}
+
 GVariant *advertisement_get_property(GDBusConnection *connection,
                                      const gchar *sender,
                                      const gchar *object_path,
@@ -81,19 +101,9 @@ GVariant *advertisement_get_property(GDBusConnection *connection,
         ret = g_variant_builder_end(builder);
         g_variant_builder_unref(builder);
     } else if (g_str_equal(property_name, "ManufacturerData")) {
-        GVariantBuilder *builder = g_variant_builder_new(G_VARIANT_TYPE("a{qv}"));
-        if (advertisement->manufacturer_data != NULL && g_hash_table_size(advertisement->manufacturer_data) > 0) {
-            g_hash_table_foreach(advertisement->manufacturer_data, add_manufacturer_data, builder);
-        }
-        ret = g_variant_builder_end(builder);
-        g_variant_builder_unref(builder);
+        ret = binc_internal_manufacturer_data_variant(advertisement);
     } else if (g_str_equal(property_name, "ServiceData")) {
-        GVariantBuilder *builder = g_variant_builder_new(G_VARIANT_TYPE("a{sv}"));
-        if (advertisement->service_data != NULL && g_hash_table_size(advertisement->service_data) > 0) {
-            g_hash_table_foreach(advertisement->service_data, add_service_data, builder);
-        }
-        ret = g_variant_builder_end(builder);
-        g_variant_builder_unref(builder);
+        ret = binc_internal_service_data_variant(advertisement);
     } else if (g_str_equal(property_name, "MinInterval")) {
         // May require experimental to be enabled
         // See https://github.com/bluez/bluez/commit/7e028287ae1a94b47093cfb328645ae1c74a2ea7
@@ -164,6 +174,7 @@ void binc_advertisement_unregister(Advertisement *advertisement, const Adapter *
     if (!result) {
         log_debug(TAG, "failed to unregister advertisement");
     }
+    advertisement->registration_id = 0;
 }
 
 static void byte_array_free(GByteArray *byteArray) { g_byte_array_free(byteArray, TRUE); }
@@ -26,12 +26,27 @@
 #include "device.h"
 #include "device_internal.h"
 #include "logger.h"
+#include "utility.h"
 #include <errno.h>
 #include <glib.h>
 #include <stdio.h>
 
 #define TAG "Agent"
 
+// Defaults for the bonding pipeline
+#define DEFAULT_BOND_MAX_IN_FLIGHT 4
+#define DEFAULT_BOND_TIMEOUT_MS 30000
+#define DEFAULT_BOND_MAX_RETRIES 1
+#define BOND_RETRY_BACKOFF_MS 1000
+
+typedef struct binc_bond_request {
+    Agent *agent; // Borrowed
+    Device *device; // Borrowed
+    guint attempts;
+    guint timer;
+    gboolean attempting;
+} BondRequest;
+
 struct binc_agent {
     char *path; // Owned
     IoCapability io_capability;
@@ -40,6 +55,13 @@ struct binc_agent {
     guint registration_id;
     AgentRequestAuthorizationCallback request_authorization_callback;
     AgentRequestPasskeyCallback request_passkey_callback;
+    AgentPasskeyLookupCallback passkey_lookup_callback;
+    GQueue *bond_queue; // Owned, devices are borrowed
+    GHashTable *bond_requests; // Owned, device path -> BondRequest
+    guint bonds_attempting;
+    guint bond_max_in_flight;
+    guint bond_timeout_ms;
+    guint bond_max_retries;
 };
 
 void binc_agent_free(Agent *agent) {
@@ -49,6 +71,16 @@ void binc_agent_free(Agent *agent) {
         log_debug(TAG, "could not unregister agent");
     }
 
+    if (agent->bond_requests != NULL) {
+        g_hash_table_destroy(agent->bond_requests);
+        agent->bond_requests = NULL;
+    }
+
+    if (agent->bond_queue != NULL) {
+        g_queue_free(agent->bond_queue);
+        agent->bond_queue = NULL;
+    }
+
     g_free((char *) agent->path);
     agent->path = NULL;
 
@@ -101,7 +133,11 @@ static void bluez_agent_method_call(GDBusConnection *conn,
             binc_device_set_bonding_state(device, BINC_BONDING);
         }
 
-        if (agent->request_passkey_callback != NULL) {
+        // Per-device lookup first so concurrent pairings each get their own passkey
+        if (device != NULL && agent->passkey_lookup_callback != NULL &&
+            agent->passkey_lookup_callback(device, &pass)) {
+            g_dbus_method_invocation_return_value(invocation, g_variant_new("(u)", pass));
+        } else if (agent->request_passkey_callback != NULL) {
             pass = agent->request_passkey_callback(device);
             g_dbus_method_invocation_return_value(invocation, g_variant_new("(u)", pass));
         } else {
@@ -276,17 +312,154 @@ int binc_agentmanager_register_agent(Agent *agent) {
     return result;
 }
 
+static void binc_internal_bond_request_free(BondRequest *request) {
+    if (request->timer != 0) {
+        binc_source_remove(request->timer);
+        request->timer = 0;
+    }
+    binc_internal_device_set_bonding_observer(request->device, NULL, NULL);
+    g_free(request);
+}
+
 Agent *binc_agent_create(Adapter *adapter, const char *path, IoCapability io_capability) {
     Agent *agent = g_new0(Agent, 1);
     agent->path = g_strdup(path);
     agent->connection = binc_adapter_get_dbus_connection(adapter);
     agent->adapter = adapter;
     agent->io_capability = io_capability;
+    agent->bond_queue = g_queue_new();
+    agent->bond_requests = g_hash_table_new_full(g_str_hash, g_str_equal, g_free,
+                                                 (GDestroyNotify) binc_internal_bond_request_free);
+    agent->bond_max_in_flight = DEFAULT_BOND_MAX_IN_FLIGHT;
+    agent->bond_timeout_ms = DEFAULT_BOND_TIMEOUT_MS;
+    agent->bond_max_retries = DEFAULT_BOND_MAX_RETRIES;
     bluez_register_agent(agent);
     binc_agentmanager_register_agent(agent);
     return agent;
 }
 
+static void binc_internal_pump_bond_queue(Agent *agent);
+
+static gboolean binc_internal_bond_timeout(gpointer user_data);
+
+static void binc_internal_bond_observer(Device *device, gpointer user_data);
+
+static gboolean binc_internal_bond_retry(gpointer user_data) {
+    BondRequest *request = (BondRequest *) user_data;
+    g_assert(request != NULL);
+
+    Agent *agent = request->agent;
+    request->attempting = TRUE;
+    request->attempts++;
+    request->timer = binc_timeout_add(agent->bond_timeout_ms, binc_internal_bond_timeout, request);
+    agent->bonds_attempting++;
+
+    log_debug(TAG, "retrying pairing of '%s' (attempt %u)", binc_device_get_address(request->device),
+              request->attempts);
+    binc_device_pair(request->device);
+    return G_SOURCE_REMOVE;
+}
+
+static void binc_internal_bond_attempt_failed(BondRequest *request) {
+    Agent *agent = request->agent;
+
+    if (request->timer != 0) {
+        binc_source_remove(request->timer);
+        request->timer = 0;
+    }
+    g_assert(agent->bonds_attempting > 0);
+    agent->bonds_attempting--;
+
+    if (request->attempts <= agent->bond_max_retries) {
+        // Back off a bit longer for every failed attempt
+        request->attempting = FALSE;
+        request->timer = binc_timeout_add(request->attempts * BOND_RETRY_BACKOFF_MS,
+                                       binc_internal_bond_retry, request);
+    } else {
+        log_debug(TAG, "giving up on pairing '%s' after %u attempts",
+                  binc_device_get_address(request->device), request->attempts);
+        g_hash_table_remove(agent->bond_requests, binc_device_get_path(request->device));
+    }
+    binc_internal_pump_bond_queue(agent);
+}
+
+static gboolean binc_internal_bond_timeout(gpointer user_data) {
+    BondRequest *request = (BondRequest *) user_data;
+    g_assert(request != NULL);
+
+    request->timer = 0;
+    log_debug(TAG, "pairing of '%s' timed out", binc_device_get_address(request->device));
+    binc_internal_bond_attempt_failed(request);
+    return G_SOURCE_REMOVE;
+}
+
+// Advance the bonding pipeline when a tracked device's bonding state settles.
+// The application's own BondingStateChangedCallback has already fired.
+static void binc_internal_bond_observer(Device *device, gpointer user_data) {
+    Agent *agent = (Agent *) user_data;
+    g_assert(agent != NULL);
+
+    BondRequest *request = g_hash_table_lookup(agent->bond_requests, binc_device_get_path(device));
+    if (request == NULL || !request->attempting) return;
+
+    BondingState state = binc_device_get_bonding_state(device);
+    if (state == BINC_BONDED) {
+        g_assert(agent->bonds_attempting > 0);
+        agent->bonds_attempting--;
+        g_hash_table_remove(agent->bond_requests, binc_device_get_path(device));
+        binc_internal_pump_bond_queue(agent);
+    } else if (state == BINC_BOND_NONE) {
+        binc_internal_bond_attempt_failed(request);
+    }
+}
+
+static void binc_internal_pump_bond_queue(Agent *agent) {
+    g_assert(agent != NULL);
+
+    while (agent->bonds_attempting < agent->bond_max_in_flight &&
+           !g_queue_is_empty(agent->bond_queue)) {
+        Device *device = g_queue_pop_head(agent->bond_queue);
+        if (binc_device_get_bonding_state(device) == BINC_BONDED) continue;
+
+        BondRequest *request = g_new0(BondRequest, 1);
+        request->agent = agent;
+        request->device = device;
+        request->attempts = 1;
+        request->attempting = TRUE;
+        request->timer = binc_timeout_add(agent->bond_timeout_ms, binc_internal_bond_timeout, request);
+        g_hash_table_insert(agent->bond_requests, g_strdup(binc_device_get_path(device)), request);
+        binc_internal_device_set_bonding_observer(device, binc_internal_bond_observer, agent);
+        agent->bonds_attempting++;
+
+        binc_device_pair(device);
+    }
+}
+
+void binc_agent_pair_all(Agent *agent, GPtrArray *devices, guint max_in_flight) {
+    g_assert(agent != NULL);
+    g_assert(devices != NULL);
+
+    agent->bond_max_in_flight = max_in_flight > 0 ? max_in_flight : DEFAULT_BOND_MAX_IN_FLIGHT;
+
+    for (guint i = 0; i < devices->len; i++) {
+        Device *device = g_ptr_array_index(devices, i);
+
+        // Skip devices that are already queued or being paired
+        if (g_hash_table_contains(agent->bond_requests, binc_device_get_path(device))) continue;
+        if (g_queue_find(agent->bond_queue, device) != NULL) continue;
+
+        g_queue_push_tail(agent->bond_queue, device);
+    }
+    binc_internal_pump_bond_queue(agent);
+}
+
+void binc_agent_set_pair_timeout(Agent *agent, guint timeout_ms, guint max_retries) {
+    g_assert(agent != NULL);
+
+    agent->bond_timeout_ms = timeout_ms > 0 ? timeout_ms : DEFAULT_BOND_TIMEOUT_MS;
+    agent->bond_max_retries = max_retries;
+}
+
 void binc_agent_set_request_authorization_cb(Agent *agent, AgentRequestAuthorizationCallback callback) {
     g_assert(agent != NULL);
     g_assert(callback != NULL);
@@ -299,6 +472,12 @@ void binc_agent_set_request_passkey_cb(Agent *agent, AgentRequestPasskeyCallback
     agent->request_passkey_callback = callback;
 }
 
+void binc_agent_set_passkey_lookup_cb(Agent *agent, AgentPasskeyLookupCallback callback) {
+    g_assert(agent != NULL);
+    g_assert(callback != NULL);
+    agent->passkey_lookup_callback = callback;
+}
+
 const char *binc_agent_get_path(const Agent *agent) {
     g_assert(agent != NULL);
     return agent->path;
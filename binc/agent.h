@@ -35,6 +35,15 @@ typedef gboolean (*AgentRequestAuthorizationCallback)(Device *device);
 
 typedef guint32 (*AgentRequestPasskeyCallback)(Device *device);
 
+/**
+ * Look up the passkey for a specific device.
+ *
+ * Consulted before the global AgentRequestPasskeyCallback, so several
+ * pairings can run concurrently with different passkeys. Return TRUE and
+ * fill 'passkey' to answer, or FALSE to fall back to the global callback.
+ */
+typedef gboolean (*AgentPasskeyLookupCallback)(Device *device, guint32 *passkey);
+
 typedef enum {
     DISPLAY_ONLY, DISPLAY_YES_NO, KEYBOARD_ONLY, NO_INPUT_NO_OUTPUT, KEYBOARD_DISPLAY
 } IoCapability;
@@ -47,6 +56,32 @@ void binc_agent_set_request_authorization_cb(Agent *agent, AgentRequestAuthoriza
 
 void binc_agent_set_request_passkey_cb(Agent *agent, AgentRequestPasskeyCallback callback);
 
+void binc_agent_set_passkey_lookup_cb(Agent *agent, AgentPasskeyLookupCallback callback);
+
+/**
+ * Pair a set of devices with a bounded number of pairings in flight.
+ *
+ * Pairings are pipelined: at most 'max_in_flight' run concurrently and the
+ * next device is taken from the queue as soon as a pairing settles. Attempts
+ * that time out or fail are retried with backoff (see
+ * binc_agent_set_pair_timeout). Completion is reported through each device's
+ * BondingStateChangedCallback as usual.
+ *
+ * @param agent the agent
+ * @param devices devices to pair (borrowed, must belong to this agent's adapter)
+ * @param max_in_flight maximum concurrent pairings, 0 for the default (4)
+ */
+void binc_agent_pair_all(Agent *agent, GPtrArray *devices, guint max_in_flight);
+
+/**
+ * Configure the per-attempt timeout and retry count used by binc_agent_pair_all.
+ *
+ * @param agent the agent
+ * @param timeout_ms per-attempt timeout in milliseconds (default 30000)
+ * @param max_retries number of retries after a failed or timed-out attempt (default 1)
+ */
+void binc_agent_set_pair_timeout(Agent *agent, guint timeout_ms, guint max_retries);
+
 void binc_agent_free(Agent *agent);
 
 const char *binc_agent_get_path(const Agent *agent);
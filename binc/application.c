@@ -26,7 +26,11 @@
 #include "logger.h"
 #include "characteristic.h"
 #include "utility.h"
+#include "stats.h"
 #include <errno.h>
+#include <gio/gunixfdlist.h>
+#include <sys/socket.h>
+#include <unistd.h>
 
 #define GATT_SERV_INTERFACE "org.bluez.GattService1"
 #define GATT_CHAR_INTERFACE "org.bluez.GattCharacteristic1"
@@ -39,8 +43,46 @@ static const char *const CHARACTERISTIC_METHOD_WRITE_VALUE = "WriteValue";
 static const char *const CHARACTERISTIC_METHOD_STOP_NOTIFY = "StopNotify";
 static const char *const CHARACTERISTIC_METHOD_START_NOTIFY = "StartNotify";
 static const char *const CHARACTERISTIC_METHOD_CONFIRM = "Confirm";
-static const char *const DESCRIPTOR_METHOD_READ_VALUE = "ReadValue";
-static const char *const DESCRIPTOR_METHOD_WRITE_VALUE = "WriteValue";
+static const char *const CHARACTERISTIC_METHOD_ACQUIRE_NOTIFY = "AcquireNotify";
+
+typedef enum {
+    GATT_METHOD_UNKNOWN,
+    GATT_METHOD_READ_VALUE,
+    GATT_METHOD_WRITE_VALUE,
+    GATT_METHOD_START_NOTIFY,
+    GATT_METHOD_STOP_NOTIFY,
+    GATT_METHOD_CONFIRM,
+    GATT_METHOD_ACQUIRE_NOTIFY
+} GattMethod;
+
+/*
+ * Resolve a D-Bus method name to an enum so the handlers can dispatch with a
+ * switch. The method names BlueZ sends all differ in their first character
+ * (except Start/StopNotify), so one switch plus a single confirming string
+ * compare replaces the chain of g_str_equal calls per incoming method call.
+ */
+static GattMethod binc_internal_gatt_method(const char *method) {
+    switch (method[0]) {
+        case 'R':
+            return g_str_equal(method, CHARACTERISTIC_METHOD_READ_VALUE) ?
+                   GATT_METHOD_READ_VALUE : GATT_METHOD_UNKNOWN;
+        case 'W':
+            return g_str_equal(method, CHARACTERISTIC_METHOD_WRITE_VALUE) ?
+                   GATT_METHOD_WRITE_VALUE : GATT_METHOD_UNKNOWN;
+        case 'S':
+            if (g_str_equal(method, CHARACTERISTIC_METHOD_START_NOTIFY)) return GATT_METHOD_START_NOTIFY;
+            if (g_str_equal(method, CHARACTERISTIC_METHOD_STOP_NOTIFY)) return GATT_METHOD_STOP_NOTIFY;
+            return GATT_METHOD_UNKNOWN;
+        case 'C':
+            return g_str_equal(method, CHARACTERISTIC_METHOD_CONFIRM) ?
+                   GATT_METHOD_CONFIRM : GATT_METHOD_UNKNOWN;
+        case 'A':
+            return g_str_equal(method, CHARACTERISTIC_METHOD_ACQUIRE_NOTIFY) ?
+                   GATT_METHOD_ACQUIRE_NOTIFY : GATT_METHOD_UNKNOWN;
+        default:
+            return GATT_METHOD_UNKNOWN;
+    }
+}
 
 static const gchar object_manager_xml[] =
         "<node name='/'>"
@@ -76,12 +118,18 @@ static const gchar characteristic_xml[] =
         "        <method name='StartNotify'/>"
         "        <method name='StopNotify' />"
         "        <method name='Confirm' />"
+        "        <method name='AcquireNotify'>"
+        "               <arg type='a{sv}' name='options' direction='in' />"
+        "               <arg type='h' name='fd' direction='out'/>"
+        "               <arg type='q' name='mtu' direction='out'/>"
+        "        </method>"
         "  </interface>"
         "  <interface name='org.freedesktop.DBus.Properties'>"
         "    <property type='s' name='UUID' access='read' />"
         "    <property type='o' name='Service' access='read' />"
         "    <property type='ay' name='Value' access='readwrite' />"
         "    <property type='b' name='Notifying' access='read' />"
+        "    <property type='b' name='NotifyAcquired' access='read' />"
         "    <property type='as' name='Flags' access='read' />"
         "    <property type='ao' name='Descriptors' access='read' />"
         "  </interface>"
@@ -107,6 +155,28 @@ static const gchar descriptor_xml[] =
         "  </interface>"
         "</node>";
 
+/*
+ * The introspection XML blobs above never change, so each one is parsed once
+ * and the resulting GDBusNodeInfo is kept for the lifetime of the process,
+ * instead of being parsed again for every object that gets registered.
+ */
+static GDBusNodeInfo *binc_internal_node_info(const gchar *xml, GDBusNodeInfo **cached) {
+    if (*cached == NULL) {
+        GError *error = NULL;
+        *cached = g_dbus_node_info_new_for_xml(xml, &error);
+        if (error != NULL) {
+            log_debug(TAG, "Unable to create node: %s\n", error->message);
+            g_clear_error(&error);
+        }
+    }
+    return *cached;
+}
+
+static GDBusNodeInfo *object_manager_node_info = NULL;
+static GDBusNodeInfo *service_node_info = NULL;
+static GDBusNodeInfo *characteristic_node_info = NULL;
+static GDBusNodeInfo *descriptor_node_info = NULL;
+
 struct binc_application {
     char *path;
     guint registration_id;
@@ -119,6 +189,9 @@ struct binc_application {
     onLocalCharacteristicStopNotify on_char_stop_notify;
     onLocalDescriptorWrite on_desc_write;
     onLocalDescriptorRead on_desc_read;
+    gboolean notify_batching;
+    GPtrArray *pending_notifications; // Owned, characteristics are borrowed
+    guint notify_flush_source;
 };
 
 typedef struct binc_local_service {
@@ -141,6 +214,10 @@ typedef struct local_characteristic {
     gboolean notifying;
     GHashTable *descriptors;
     Application *application;
+    GByteArray *notify_value; // Owned, value encoded in notify_variant
+    GVariant *notify_variant; // Owned, cached PropertiesChanged tuple for notify_value
+    int notify_fd; // Owned, write end of the acquired notification socket, -1 when not acquired
+    guint16 notify_mtu;
 } LocalCharacteristic;
 
 typedef struct local_descriptor {
@@ -222,6 +299,21 @@ static void binc_local_char_free(LocalCharacteristic *localCharacteristic) {
         localCharacteristic->value = NULL;
     }
 
+    if (localCharacteristic->notify_value != NULL) {
+        g_byte_array_free(localCharacteristic->notify_value, TRUE);
+        localCharacteristic->notify_value = NULL;
+    }
+
+    if (localCharacteristic->notify_variant != NULL) {
+        g_variant_unref(localCharacteristic->notify_variant);
+        localCharacteristic->notify_variant = NULL;
+    }
+
+    if (localCharacteristic->notify_fd != -1) {
+        close(localCharacteristic->notify_fd);
+        localCharacteristic->notify_fd = -1;
+    }
+
     g_free(localCharacteristic->path);
     localCharacteristic->path = NULL;
 
@@ -472,6 +564,11 @@ static void add_characteristics(GVariantBuilder *builder, LocalService *localSer
                               binc_local_characteristic_get_flags(localCharacteristic));
         g_variant_builder_add(char_properties_builder, "{sv}", "Notifying",
                               g_variant_new("b", localCharacteristic->notifying));
+        if (localCharacteristic->permissions & GATT_CHR_PROP_NOTIFY) {
+            // Announcing NotifyAcquired makes Bluez use AcquireNotify instead of StartNotify
+            g_variant_builder_add(char_properties_builder, "{sv}", "NotifyAcquired",
+                                  g_variant_new("b", localCharacteristic->notify_fd != -1));
+        }
         g_variant_builder_add(char_properties_builder, "{sv}", "Descriptors",
                               binc_local_characteristic_get_descriptors(localCharacteristic));
 
@@ -545,14 +642,10 @@ void binc_application_publish(Application *application, const Adapter *adapter)
     g_assert(application != NULL);
     g_assert(adapter != NULL);
 
-    GError *error = NULL;
-    GDBusNodeInfo *info = g_dbus_node_info_new_for_xml(object_manager_xml, &error);
-    if (error) {
-        log_debug(TAG, "Unable to create manager node: %s\n", error->message);
-        g_clear_error(&error);
-        return;
-    }
+    GDBusNodeInfo *info = binc_internal_node_info(object_manager_xml, &object_manager_node_info);
+    if (info == NULL) return;
 
+    GError *error = NULL;
     application->registration_id = g_dbus_connection_register_object(application->connection,
                                                                      application->path,
                                                                      info->interfaces[0],
@@ -560,7 +653,6 @@ void binc_application_publish(Application *application, const Adapter *adapter)
                                                                      application,
                                                                      NULL,
                                                                      &error);
-    g_dbus_node_info_unref(info);
 
     if (application->registration_id == 0 && error != NULL) {
         log_debug(TAG, "failed to publish application");
@@ -582,6 +674,7 @@ Application *binc_create_application(const Adapter *adapter) {
                                                   g_str_equal,
                                                   g_free,
                                                   (GDestroyNotify) binc_local_service_free);
+    application->pending_notifications = g_ptr_array_new();
 
     binc_application_publish(application, adapter);
 
@@ -594,6 +687,16 @@ void binc_application_free(Application *application) {
 
     log_debug(TAG, "freeing application %s", application->path);
 
+    if (application->notify_flush_source != 0) {
+        binc_source_remove(application->notify_flush_source);
+        application->notify_flush_source = 0;
+    }
+
+    if (application->pending_notifications != NULL) {
+        g_ptr_array_free(application->pending_notifications, TRUE);
+        application->pending_notifications = NULL;
+    }
+
     if (application->services != NULL) {
         g_hash_table_destroy(application->services);
         application->services = NULL;
@@ -621,14 +724,10 @@ int binc_application_add_service(Application *application, const char *service_u
     g_return_val_if_fail (application != NULL, EINVAL);
     g_return_val_if_fail (is_valid_uuid(service_uuid), EINVAL);
 
-    GError *error = NULL;
-    GDBusNodeInfo *info = g_dbus_node_info_new_for_xml(service_xml, &error);
-    if (error) {
-        log_debug(TAG, "Unable to create service node: %s\n", error->message);
-        g_clear_error(&error);
-        return EINVAL;
-    }
+    GDBusNodeInfo *info = binc_internal_node_info(service_xml, &service_node_info);
+    if (info == NULL) return EINVAL;
 
+    GError *error = NULL;
     LocalService *localService = g_new0(LocalService, 1);
     localService->uuid = g_strdup(service_uuid);
     localService->application = application;
@@ -650,7 +749,6 @@ int binc_application_add_service(Application *application, const char *service_u
                                                                       localService,
                                                                       NULL,
                                                                       &error);
-    g_dbus_node_info_unref(info);
 
     if (localService->registration_id == 0) {
         log_debug(TAG, "failed to publish local service");
@@ -737,9 +835,7 @@ static int binc_characteristic_set_value(const Application *application, LocalCh
     g_return_val_if_fail (characteristic != NULL, EINVAL);
     g_return_val_if_fail (byteArray != NULL, EINVAL);
 
-    GString *byteArrayStr = g_byte_array_as_hex(byteArray);
-    log_debug(TAG, "set value <%s> to <%s>", byteArrayStr->str, characteristic->uuid);
-    g_string_free(byteArrayStr, TRUE);
+    log_debug_hex(TAG, byteArray, "set value <%s> to <%s>", characteristic->uuid);
 
     if (characteristic->value != NULL) {
         g_byte_array_free(characteristic->value, TRUE);
@@ -764,9 +860,7 @@ static int binc_descriptor_set_value(const Application *application, LocalDescri
     g_return_val_if_fail (descriptor != NULL, EINVAL);
     g_return_val_if_fail (byteArray != NULL, EINVAL);
 
-    GString *byteArrayStr = g_byte_array_as_hex(byteArray);
-    log_debug(TAG, "set value <%s> to <%s>", byteArrayStr->str, descriptor->uuid);
-    g_string_free(byteArrayStr, TRUE);
+    log_debug_hex(TAG, byteArray, "set value <%s> to <%s>", descriptor->uuid);
 
     if (descriptor->value != NULL) {
         g_byte_array_free(descriptor->value, TRUE);
@@ -825,70 +919,77 @@ static void binc_internal_descriptor_method_call(GDBusConnection *conn,
     Application *application = localDescriptor->application;
     g_assert(application != NULL);
 
-    if (g_str_equal(method, DESCRIPTOR_METHOD_READ_VALUE)) {
-        ReadOptions *options = parse_read_options(params);
-
-        log_debug(TAG, "read descriptor <%s> by ", localDescriptor->uuid, options->device);
-
-        const char *result = NULL;
-        if (application->on_desc_read != NULL) {
-            result = application->on_desc_read(localDescriptor->application, options->device,
-                                               localDescriptor->service_uuid,
-                                               localDescriptor->char_uuid, localDescriptor->uuid);
-        }
-        read_options_free(options);
-
-        if (result) {
-            g_dbus_method_invocation_return_dbus_error(invocation, result, "read descriptor error");
-            log_debug(TAG, "read descriptor error");
-            return;
-        }
-
-        if (localDescriptor->value != NULL) {
-            GVariant *resultVariant = g_variant_new_fixed_array(G_VARIANT_TYPE_BYTE,
-                                                                localDescriptor->value->data,
-                                                                localDescriptor->value->len,
-                                                                sizeof(guint8));
-            g_dbus_method_invocation_return_value(invocation, g_variant_new_tuple(&resultVariant, 1));
-        } else {
-            g_dbus_method_invocation_return_dbus_error(invocation, BLUEZ_ERROR_FAILED, "no value for descriptor");
-        }
-    } else if (g_str_equal(method, DESCRIPTOR_METHOD_WRITE_VALUE)) {
-        g_assert(g_str_equal(g_variant_get_type_string(params), "(aya{sv})"));
-        GVariant *valueVariant, *optionsVariant;
-
-        // Get the options
-        g_variant_get(params, "(@ay@a{sv})", &valueVariant, &optionsVariant);
-        WriteOptions *options = parse_write_options(optionsVariant);
-        g_variant_unref(optionsVariant);
-
-        // Get the byte array to be written
-        GByteArray *byteArray = g_variant_get_byte_array(valueVariant);
-        g_variant_unref(valueVariant);
-
-        log_debug(TAG, "write descriptor <%s> by %s", localDescriptor->uuid, options->device);
-
-        // Allow application to accept/reject the characteristic value before setting it
-        const char *result = NULL;
-        if (application->on_desc_write != NULL) {
-            result = application->on_desc_write(localDescriptor->application,
-                                                options->device,
-                                                localDescriptor->service_uuid,
-                                                localDescriptor->char_uuid,
-                                                localDescriptor->uuid,
-                                                byteArray);
+    switch (binc_internal_gatt_method(method)) {
+        case GATT_METHOD_READ_VALUE: {
+            ReadOptions *options = parse_read_options(params);
+
+            log_debug(TAG, "read descriptor <%s> by ", localDescriptor->uuid, options->device);
+
+            const char *result = NULL;
+            if (application->on_desc_read != NULL) {
+                result = application->on_desc_read(localDescriptor->application, options->device,
+                                                   localDescriptor->service_uuid,
+                                                   localDescriptor->char_uuid, localDescriptor->uuid);
+            }
+            read_options_free(options);
+
+            if (result) {
+                g_dbus_method_invocation_return_dbus_error(invocation, result, "read descriptor error");
+                log_debug(TAG, "read descriptor error");
+                return;
+            }
+
+            if (localDescriptor->value != NULL) {
+                GVariant *resultVariant = g_variant_new_fixed_array(G_VARIANT_TYPE_BYTE,
+                                                                    localDescriptor->value->data,
+                                                                    localDescriptor->value->len,
+                                                                    sizeof(guint8));
+                g_dbus_method_invocation_return_value(invocation, g_variant_new_tuple(&resultVariant, 1));
+            } else {
+                g_dbus_method_invocation_return_dbus_error(invocation, BLUEZ_ERROR_FAILED, "no value for descriptor");
+            }
+            break;
         }
-        write_options_free(options);
-
-        if (result) {
-            g_dbus_method_invocation_return_dbus_error(invocation, result, "write error");
-            log_debug(TAG, "write error");
-            return;
+        case GATT_METHOD_WRITE_VALUE: {
+            g_assert(g_str_equal(g_variant_get_type_string(params), "(aya{sv})"));
+            GVariant *valueVariant, *optionsVariant;
+
+            // Get the options
+            g_variant_get(params, "(@ay@a{sv})", &valueVariant, &optionsVariant);
+            WriteOptions *options = parse_write_options(optionsVariant);
+            g_variant_unref(optionsVariant);
+
+            // Get the byte array to be written
+            GByteArray *byteArray = g_variant_get_byte_array(valueVariant);
+            g_variant_unref(valueVariant);
+
+            log_debug(TAG, "write descriptor <%s> by %s", localDescriptor->uuid, options->device);
+
+            // Allow application to accept/reject the characteristic value before setting it
+            const char *result = NULL;
+            if (application->on_desc_write != NULL) {
+                result = application->on_desc_write(localDescriptor->application,
+                                                    options->device,
+                                                    localDescriptor->service_uuid,
+                                                    localDescriptor->char_uuid,
+                                                    localDescriptor->uuid,
+                                                    byteArray);
+            }
+            write_options_free(options);
+
+            if (result) {
+                g_dbus_method_invocation_return_dbus_error(invocation, result, "write error");
+                log_debug(TAG, "write error");
+                return;
+            }
+
+            binc_descriptor_set_value(application, localDescriptor, byteArray);
+
+            g_dbus_method_invocation_return_value(invocation, g_variant_new("()"));
+            break;
         }
-
-        binc_descriptor_set_value(application, localDescriptor, byteArray);
-
-        g_dbus_method_invocation_return_value(invocation, g_variant_new("()"));
+        default:
+            break;
     }
 }
 
@@ -907,14 +1008,10 @@ int binc_application_add_descriptor(Application *application, const char *servic
         return EINVAL;
     }
 
-    GError *error = NULL;
-    GDBusNodeInfo *info = g_dbus_node_info_new_for_xml(descriptor_xml, &error);
-    if (error) {
-        log_debug(TAG, "Unable to create descriptor node: %s\n", error->message);
-        g_clear_error(&error);
-        return EINVAL;
-    }
+    GDBusNodeInfo *info = binc_internal_node_info(descriptor_xml, &descriptor_node_info);
+    if (info == NULL) return EINVAL;
 
+    GError *error = NULL;
     LocalDescriptor *localDescriptor = g_new0(LocalDescriptor, 1);
     localDescriptor->uuid = g_strdup(desc_uuid);
     localDescriptor->application = application;
@@ -935,7 +1032,6 @@ int binc_application_add_descriptor(Application *application, const char *servic
                                                                          localDescriptor,
                                                                          NULL,
                                                                          &error);
-    g_dbus_node_info_unref(info);
 
     if (localDescriptor->registration_id == 0) {
         log_debug(TAG, "failed to publish local characteristic");
@@ -1004,6 +1100,21 @@ GByteArray *binc_application_get_char_value(const Application *application, cons
 }
 
 
+static void binc_internal_close_notify_fd(LocalCharacteristic *characteristic) {
+    g_assert(characteristic != NULL);
+
+    if (characteristic->notify_fd == -1) return;
+
+    close(characteristic->notify_fd);
+    characteristic->notify_fd = -1;
+    characteristic->notifying = FALSE;
+
+    Application *application = characteristic->application;
+    if (application->on_char_stop_notify != NULL) {
+        application->on_char_stop_notify(application, characteristic->service_uuid, characteristic->uuid);
+    }
+}
+
 static void binc_internal_characteristic_method_call(GDBusConnection *conn,
                                                      const gchar *sender,
                                                      const gchar *path,
@@ -1019,97 +1130,162 @@ static void binc_internal_characteristic_method_call(GDBusConnection *conn,
     Application *application = characteristic->application;
     g_assert(application != NULL);
 
-    if (g_str_equal(method, CHARACTERISTIC_METHOD_READ_VALUE)) {
-        log_debug(TAG, "read <%s>", characteristic->uuid);
-        ReadOptions *options = parse_read_options(params);
-
-        // Allow application to accept/reject the characteristic value before setting it
-        const char *result = NULL;
-        if (application->on_char_read != NULL) {
-            result = application->on_char_read(characteristic->application, options->device,
-                                               characteristic->service_uuid,
-                                               characteristic->uuid);
+    switch (binc_internal_gatt_method(method)) {
+        case GATT_METHOD_READ_VALUE: {
+            log_debug(TAG, "read <%s>", characteristic->uuid);
+            ReadOptions *options = parse_read_options(params);
+
+            // Allow application to accept/reject the characteristic value before setting it
+            const char *result = NULL;
+            if (application->on_char_read != NULL) {
+                result = application->on_char_read(characteristic->application, options->device,
+                                                   characteristic->service_uuid,
+                                                   characteristic->uuid);
+            }
+            read_options_free(options);
+
+            if (result) {
+                g_dbus_method_invocation_return_dbus_error(invocation, result, "read characteristic error");
+                log_debug(TAG, "read characteristic error '%s'", result);
+                return;
+            }
+
+            // TODO deal with the offset & mtu parameter
+            if (characteristic->value != NULL) {
+                GVariant *resultVariant = g_variant_new_fixed_array(G_VARIANT_TYPE_BYTE,
+                                                                    characteristic->value->data,
+                                                                    characteristic->value->len,
+                                                                    sizeof(guint8));
+                g_dbus_method_invocation_return_value(invocation, g_variant_new_tuple(&resultVariant, 1));
+            } else {
+                g_dbus_method_invocation_return_dbus_error(invocation, BLUEZ_ERROR_FAILED, "no value");
+            }
+            break;
         }
-        read_options_free(options);
-
-        if (result) {
-            g_dbus_method_invocation_return_dbus_error(invocation, result, "read characteristic error");
-            log_debug(TAG, "read characteristic error '%s'", result);
-            return;
+        case GATT_METHOD_WRITE_VALUE: {
+            g_assert(g_str_equal(g_variant_get_type_string(params), "(aya{sv})"));
+            GVariant *valueVariant, *optionsVariant;
+
+            // Get the write options
+            g_variant_get(params, "(@ay@a{sv})", &valueVariant, &optionsVariant);
+            WriteOptions *options = parse_write_options(optionsVariant);
+            g_variant_unref(optionsVariant);
+
+            // Get the byte array to be written
+            GByteArray *byteArray = g_variant_get_byte_array(valueVariant);
+
+            log_debug(TAG, "write <%s>", characteristic->uuid);
+
+            // Allow application to accept/reject the characteristic value before setting it
+            const char *result = NULL;
+            if (application->on_char_write != NULL) {
+                result = application->on_char_write(characteristic->application, options->device,
+                                                    characteristic->service_uuid,
+                                                    characteristic->uuid, byteArray);
+            }
+            write_options_free(options);
+
+            if (result) {
+                g_dbus_method_invocation_return_dbus_error(invocation, result, "write error");
+                log_debug(TAG, "write error");
+                return;
+            }
+
+            // TODO deal with offset and mtu
+            binc_characteristic_set_value(application, characteristic, byteArray);
+
+            if (byteArray != NULL) {
+                g_byte_array_free(byteArray, FALSE);
+            }
+
+            g_variant_unref(valueVariant);
+
+            g_dbus_method_invocation_return_value(invocation, g_variant_new("()"));
+            break;
         }
+        case GATT_METHOD_START_NOTIFY: {
+            log_debug(TAG, "start notify <%s>", characteristic->uuid);
 
-        // TODO deal with the offset & mtu parameter
-        if (characteristic->value != NULL) {
-            GVariant *resultVariant = g_variant_new_fixed_array(G_VARIANT_TYPE_BYTE,
-                                                                characteristic->value->data,
-                                                                characteristic->value->len,
-                                                                sizeof(guint8));
-            g_dbus_method_invocation_return_value(invocation, g_variant_new_tuple(&resultVariant, 1));
-        } else {
-            g_dbus_method_invocation_return_dbus_error(invocation, BLUEZ_ERROR_FAILED, "no value");
-        }
-    } else if (g_str_equal(method, CHARACTERISTIC_METHOD_WRITE_VALUE)) {
-        g_assert(g_str_equal(g_variant_get_type_string(params), "(aya{sv})"));
-        GVariant *valueVariant, *optionsVariant;
-
-        // Get the write options
-        g_variant_get(params, "(@ay@a{sv})", &valueVariant, &optionsVariant);
-        WriteOptions *options = parse_write_options(optionsVariant);
-        g_variant_unref(optionsVariant);
-
-        // Get the byte array to be written
-        GByteArray *byteArray = g_variant_get_byte_array(valueVariant);
-
-        log_debug(TAG, "write <%s>", characteristic->uuid);
-
-        // Allow application to accept/reject the characteristic value before setting it
-        const char *result = NULL;
-        if (application->on_char_write != NULL) {
-            result = application->on_char_write(characteristic->application, options->device,
-                                                characteristic->service_uuid,
-                                                characteristic->uuid, byteArray);
-        }
-        write_options_free(options);
+            characteristic->notifying = TRUE;
+            g_dbus_method_invocation_return_value(invocation, g_variant_new("()"));
 
-        if (result) {
-            g_dbus_method_invocation_return_dbus_error(invocation, result, "write error");
-            log_debug(TAG, "write error");
-            return;
+            if (application->on_char_start_notify != NULL) {
+                application->on_char_start_notify(characteristic->application, characteristic->service_uuid,
+                                                  characteristic->uuid);
+            }
+            break;
         }
+        case GATT_METHOD_STOP_NOTIFY: {
+            log_debug(TAG, "stop notify <%s>", characteristic->uuid);
 
-        // TODO deal with offset and mtu
-        binc_characteristic_set_value(application, characteristic, byteArray);
+            characteristic->notifying = FALSE;
+            g_dbus_method_invocation_return_value(invocation, g_variant_new("()"));
 
-        if (byteArray != NULL) {
-            g_byte_array_free(byteArray, FALSE);
+            if (application->on_char_stop_notify != NULL) {
+                application->on_char_stop_notify(characteristic->application, characteristic->service_uuid,
+                                                 characteristic->uuid);
+            }
+            break;
         }
-
-        g_variant_unref(valueVariant);
-
-        g_dbus_method_invocation_return_value(invocation, g_variant_new("()"));
-    } else if (g_str_equal(method, CHARACTERISTIC_METHOD_START_NOTIFY)) {
-        log_debug(TAG, "start notify <%s>", characteristic->uuid);
-
-        characteristic->notifying = TRUE;
-        g_dbus_method_invocation_return_value(invocation, g_variant_new("()"));
-
-        if (application->on_char_start_notify != NULL) {
-            application->on_char_start_notify(characteristic->application, characteristic->service_uuid,
-                                              characteristic->uuid);
+        case GATT_METHOD_CONFIRM: {
+            log_debug(TAG, "indication confirmed <%s>", characteristic->uuid);
+            g_dbus_method_invocation_return_value(invocation, g_variant_new("()"));
+            break;
         }
-    } else if (g_str_equal(method, CHARACTERISTIC_METHOD_STOP_NOTIFY)) {
-        log_debug(TAG, "stop notify <%s>", characteristic->uuid);
-
-        characteristic->notifying = FALSE;
-        g_dbus_method_invocation_return_value(invocation, g_variant_new("()"));
-
-        if (application->on_char_stop_notify != NULL) {
-            application->on_char_stop_notify(characteristic->application, characteristic->service_uuid,
-                                             characteristic->uuid);
+        case GATT_METHOD_ACQUIRE_NOTIFY: {
+            g_assert(g_str_equal(g_variant_get_type_string(params), "(a{sv})"));
+
+            guint16 mtu = 23;
+            GVariantIter *optionsVariant;
+            g_variant_get(params, "(a{sv})", &optionsVariant);
+            GVariant *property_value;
+            gchar *property_name;
+            while (g_variant_iter_loop(optionsVariant, "{&sv}", &property_name, &property_value)) {
+                if (g_str_equal(property_name, "mtu")) {
+                    mtu = g_variant_get_uint16(property_value);
+                }
+            }
+            g_variant_iter_free(optionsVariant);
+
+            int fds[2];
+            if (socketpair(AF_LOCAL, SOCK_SEQPACKET | SOCK_NONBLOCK | SOCK_CLOEXEC, 0, fds) < 0) {
+                log_debug(TAG, "failed to create socket pair for <%s>", characteristic->uuid);
+                g_dbus_method_invocation_return_dbus_error(invocation, BLUEZ_ERROR_FAILED, "socketpair failed");
+                return;
+            }
+
+            GError *error = NULL;
+            GUnixFDList *fd_list = g_unix_fd_list_new();
+            gint fd_index = g_unix_fd_list_append(fd_list, fds[1], &error);
+            close(fds[1]);
+            if (fd_index < 0) {
+                log_debug(TAG, "failed to append fd (error %d: %s)", error->code, error->message);
+                g_clear_error(&error);
+                g_object_unref(fd_list);
+                close(fds[0]);
+                g_dbus_method_invocation_return_dbus_error(invocation, BLUEZ_ERROR_FAILED, "fd list failed");
+                return;
+            }
+
+            binc_internal_close_notify_fd(characteristic);
+            characteristic->notify_fd = fds[0];
+            characteristic->notify_mtu = mtu;
+            characteristic->notifying = TRUE;
+
+            log_debug(TAG, "notify acquired <%s> (mtu=%u)", characteristic->uuid, (unsigned int) mtu);
+            g_dbus_method_invocation_return_value_with_unix_fd_list(invocation,
+                                                                    g_variant_new("(hq)", fd_index, mtu),
+                                                                    fd_list);
+            g_object_unref(fd_list);
+
+            if (application->on_char_start_notify != NULL) {
+                application->on_char_start_notify(characteristic->application, characteristic->service_uuid,
+                                                  characteristic->uuid);
+            }
+            break;
         }
-    } else if (g_str_equal(method, CHARACTERISTIC_METHOD_CONFIRM)) {
-        log_debug(TAG, "indication confirmed <%s>", characteristic->uuid);
-        g_dbus_method_invocation_return_value(invocation, g_variant_new("()"));
+        default:
+            break;
     }
 }
 
@@ -1134,6 +1310,8 @@ GVariant *characteristic_get_property(GDBusConnection *connection,
         ret = binc_local_characteristic_get_flags(characteristic);
     } else if (g_str_equal(property_name, "Notifying")) {
         ret = g_variant_new_boolean(characteristic->notifying);
+    } else if (g_str_equal(property_name, "NotifyAcquired")) {
+        ret = g_variant_new_boolean(characteristic->notify_fd != -1);
     } else if (g_str_equal(property_name, "Value")) {
         ret = g_variant_new_fixed_array(G_VARIANT_TYPE_BYTE, characteristic->value->data, characteristic->value->len,
                                         sizeof(guint8));
@@ -1159,15 +1337,10 @@ int binc_application_add_characteristic(Application *application, const char *se
         return EINVAL;
     }
 
-    GError *error = NULL;
-    GDBusNodeInfo *info = NULL;
-    info = g_dbus_node_info_new_for_xml(characteristic_xml, &error);
-    if (error) {
-        log_debug(TAG, "Unable to create node: %s\n", error->message);
-        g_clear_error(&error);
-        return EINVAL;
-    }
+    GDBusNodeInfo *info = binc_internal_node_info(characteristic_xml, &characteristic_node_info);
+    if (info == NULL) return EINVAL;
 
+    GError *error = NULL;
     LocalCharacteristic *characteristic = g_new0(LocalCharacteristic, 1);
     characteristic->service_uuid = g_strdup(service_uuid);
     characteristic->service_path = g_strdup(localService->path);
@@ -1176,6 +1349,7 @@ int binc_application_add_characteristic(Application *application, const char *se
     characteristic->flags = permissions2Flags(permissions);
     characteristic->value = NULL;
     characteristic->application = application;
+    characteristic->notify_fd = -1;
     characteristic->path = g_strdup_printf("%s/char%d",
                                            localService->path,
                                            g_hash_table_size(localService->characteristics));
@@ -1194,7 +1368,6 @@ int binc_application_add_characteristic(Application *application, const char *se
                                                                         characteristic,
                                                                         NULL,
                                                                         &error);
-    g_dbus_node_info_unref(info);
 
     if (characteristic->registration_id == 0) {
         log_debug(TAG, "failed to publish local characteristic");
@@ -1262,6 +1435,96 @@ void binc_application_set_char_stop_notify_cb(Application *application, onLocalC
     application->on_char_stop_notify = callback;
 }
 
+/*
+ * Update the cached PropertiesChanged tuple for a characteristic. The tuple is
+ * rebuilt only when the value actually changed, so notifying the same value
+ * repeatedly (e.g. a high-rate sensor that saturated) reuses the same variant.
+ */
+static void binc_internal_update_notify_variant(LocalCharacteristic *characteristic, const GByteArray *byteArray) {
+    if (characteristic->notify_variant != NULL &&
+        characteristic->notify_value != NULL &&
+        characteristic->notify_value->len == byteArray->len &&
+        memcmp(characteristic->notify_value->data, byteArray->data, byteArray->len) == 0) {
+        return;
+    }
+
+    if (characteristic->notify_value != NULL) {
+        g_byte_array_free(characteristic->notify_value, TRUE);
+    }
+    characteristic->notify_value = g_byte_array_sized_new(byteArray->len);
+    g_byte_array_append(characteristic->notify_value, byteArray->data, byteArray->len);
+
+    GVariant *valueVariant = g_variant_new_fixed_array(G_VARIANT_TYPE_BYTE,
+                                                       characteristic->notify_value->data,
+                                                       characteristic->notify_value->len,
+                                                       sizeof(guint8));
+    GVariantBuilder *properties_builder = g_variant_builder_new(G_VARIANT_TYPE("a{sv}"));
+    g_variant_builder_add(properties_builder, "{sv}", "Value", valueVariant);
+    GVariantBuilder *invalidated_builder = g_variant_builder_new(G_VARIANT_TYPE("as"));
+
+    if (characteristic->notify_variant != NULL) {
+        g_variant_unref(characteristic->notify_variant);
+    }
+    characteristic->notify_variant = g_variant_ref_sink(g_variant_new("(sa{sv}as)",
+                                                                      GATT_CHAR_INTERFACE,
+                                                                      properties_builder, invalidated_builder));
+    g_variant_builder_unref(invalidated_builder);
+    g_variant_builder_unref(properties_builder);
+}
+
+static int binc_internal_emit_notify(Application *application, LocalCharacteristic *characteristic) {
+    // When a central acquired the notifications, write straight to the socket and skip D-Bus
+    if (characteristic->notify_fd != -1) {
+        ssize_t written = send(characteristic->notify_fd, characteristic->notify_value->data,
+                               characteristic->notify_value->len, MSG_NOSIGNAL);
+        if (written < 0) {
+            log_debug(TAG, "failed to write notification for <%s> (errno %d)", characteristic->uuid, errno);
+            if (errno != EAGAIN && errno != EWOULDBLOCK) {
+                binc_internal_close_notify_fd(characteristic);
+            }
+            return EINVAL;
+        }
+    } else {
+        GError *error = NULL;
+        gboolean result = g_dbus_connection_emit_signal(application->connection,
+                                                        NULL,
+                                                        characteristic->path,
+                                                        "org.freedesktop.DBus.Properties",
+                                                        "PropertiesChanged",
+                                                        characteristic->notify_variant,
+                                                        &error);
+        if (result != TRUE) {
+            if (error != NULL) {
+                log_debug(TAG, "error emitting signal: %s", error->message);
+                g_clear_error(&error);
+            }
+            return EINVAL;
+        }
+    }
+
+    binc_internal_stats_add(BINC_STATS_NOTIFICATIONS_SENT, 1);
+
+    log_debug_hex(TAG, characteristic->notify_value, "notified <%s> on <%s>", characteristic->uuid);
+    return 0;
+}
+
+static gboolean binc_internal_flush_notifications(gpointer user_data) {
+    Application *application = (Application *) user_data;
+    g_assert(application != NULL);
+
+    application->notify_flush_source = 0;
+    for (guint i = 0; i < application->pending_notifications->len; i++) {
+        binc_internal_emit_notify(application, g_ptr_array_index(application->pending_notifications, i));
+    }
+    g_ptr_array_set_size(application->pending_notifications, 0);
+    return G_SOURCE_REMOVE;
+}
+
+void binc_application_set_notify_batching(Application *application, gboolean enabled) {
+    g_assert(application != NULL);
+    application->notify_batching = enabled;
+}
+
 int binc_application_notify(const Application *application, const char *service_uuid, const char *char_uuid,
                             const GByteArray *byteArray) {
 
@@ -1270,46 +1533,28 @@ int binc_application_notify(const Application *application, const char *service_
     g_return_val_if_fail (is_valid_uuid(service_uuid), EINVAL);
     g_return_val_if_fail (is_valid_uuid(char_uuid), EINVAL);
 
+    Application *self = (Application *) application;
     LocalCharacteristic *characteristic = get_local_characteristic(application, service_uuid, char_uuid);
     if (characteristic == NULL) {
         g_critical("%s: characteristic %s does not exist", G_STRFUNC, service_uuid);
         return EINVAL;
     }
 
-    GVariant *valueVariant = g_variant_new_fixed_array(G_VARIANT_TYPE_BYTE,
-                                                       byteArray->data,
-                                                       byteArray->len,
-                                                       sizeof(guint8));
-    GVariantBuilder *properties_builder = g_variant_builder_new(G_VARIANT_TYPE("a{sv}"));
-    g_variant_builder_add(properties_builder, "{sv}", "Value", valueVariant);
-    GVariantBuilder *invalidated_builder = g_variant_builder_new(G_VARIANT_TYPE("as"));
-
-    GError *error = NULL;
-    gboolean result = g_dbus_connection_emit_signal(application->connection,
-                                                    NULL,
-                                                    characteristic->path,
-                                                    "org.freedesktop.DBus.Properties",
-                                                    "PropertiesChanged",
-                                                    g_variant_new("(sa{sv}as)",
-                                                                  "org.bluez.GattCharacteristic1",
-                                                                  properties_builder, invalidated_builder),
-                                                    &error);
+    binc_internal_update_notify_variant(characteristic, byteArray);
 
-    g_variant_builder_unref(invalidated_builder);
-    g_variant_builder_unref(properties_builder);
-
-    if (result != TRUE) {
-        if (error != NULL) {
-            log_debug(TAG, "error emitting signal: %s", error->message);
-            g_clear_error(&error);
+    if (self->notify_batching && characteristic->notify_fd == -1) {
+        // Coalesce to one emission per characteristic per mainloop iteration, latest value wins
+        guint index;
+        if (!g_ptr_array_find(self->pending_notifications, characteristic, &index)) {
+            g_ptr_array_add(self->pending_notifications, characteristic);
         }
-        return EINVAL;
+        if (self->notify_flush_source == 0) {
+            self->notify_flush_source = binc_idle_add(binc_internal_flush_notifications, self);
+        }
+        return 0;
     }
 
-    GString *byteArrayStr = g_byte_array_as_hex(byteArray);
-    log_debug(TAG, "notified <%s> on <%s>", byteArrayStr->str, characteristic->uuid);
-    g_string_free(byteArrayStr, TRUE);
-    return 0;
+    return binc_internal_emit_notify(self, characteristic);
 }
 
 gboolean binc_application_char_is_notifying(const Application *application, const char *service_uuid,
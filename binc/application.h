@@ -116,6 +116,20 @@ int binc_application_set_desc_value(const Application *application, const char *
 int binc_application_notify(const Application *application, const char *service_uuid, const char *char_uuid,
                             const GByteArray *byteArray);
 
+/**
+ * Batch notifications into one flush per mainloop iteration.
+ *
+ * When enabled, binc_application_notify() queues the notification and emits
+ * the PropertiesChanged signals from an idle callback, coalescing repeated
+ * updates of the same characteristic so only the latest value is sent.
+ * Disabled by default; notifications over an acquired socket are always
+ * written immediately.
+ *
+ * @param application the application
+ * @param enabled TRUE to batch notifications
+ */
+void binc_application_set_notify_batching(Application *application, gboolean enabled);
+
 gboolean binc_application_char_is_notifying(const Application *application, const char *service_uuid,
                                             const char *char_uuid);
 
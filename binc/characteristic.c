@@ -21,9 +21,15 @@
  *
  */
 
+#include <unistd.h>
+#include <errno.h>
+#include <glib-unix.h>
+#include <gio/gunixfdlist.h>
 #include "characteristic.h"
 #include "logger.h"
 #include "utility.h"
+#include "uuid.h"
+#include "stats.h"
 #include "device_internal.h"
 
 static const char *const TAG = "Characteristic";
@@ -34,28 +40,75 @@ static const char *const CHARACTERISTIC_METHOD_READ_VALUE = "ReadValue";
 static const char *const CHARACTERISTIC_METHOD_WRITE_VALUE = "WriteValue";
 static const char *const CHARACTERISTIC_METHOD_STOP_NOTIFY = "StopNotify";
 static const char *const CHARACTERISTIC_METHOD_START_NOTIFY = "StartNotify";
+static const char *const CHARACTERISTIC_METHOD_ACQUIRE_NOTIFY = "AcquireNotify";
+static const char *const CHARACTERISTIC_METHOD_ACQUIRE_WRITE = "AcquireWrite";
 static const char *const CHARACTERISTIC_PROPERTY_NOTIFYING = "Notifying";
 static const char *const CHARACTERISTIC_PROPERTY_VALUE = "Value";
 
+// Maximum ATT MTU (BlueZ caps at 517) so fd reads can use a stack buffer
+#define MAX_ATT_MTU 517
+
+// ATT header taken off the MTU for a write command payload
+#define ATT_WRITE_HEADER_SIZE 3
+
+// ATT header taken off the MTU for a read response payload
+#define ATT_READ_HEADER_SIZE 1
+
+// Number of write-without-response commands kept in flight by the write queue
+#define DEFAULT_WRITE_QUEUE_DEPTH 4
+
 typedef struct binc_write_data {
     GVariant *value;
     Characteristic *characteristic;
 } WriteData;
 
+typedef struct binc_read_stream {
+    Characteristic *characteristic; // Borrowed
+    GByteArray *buffer; // Owned
+    OnStreamProgressCallback progress_callback;
+    OnReadStreamCompleteCallback complete_callback;
+} ReadStream;
+
+typedef struct binc_write_stream {
+    Characteristic *characteristic; // Borrowed
+    GByteArray *data; // Owned
+    gsize next_offset;
+    gsize bytes_acked;
+    guint chunks_in_flight;
+    GError *error; // Owned, first error that occurred
+    OnStreamProgressCallback progress_callback;
+    OnWriteStreamCompleteCallback complete_callback;
+} WriteStream;
+
+typedef struct binc_write_stream_chunk {
+    WriteStream *stream; // Borrowed
+    gsize size;
+} WriteStreamChunk;
+
 struct binc_characteristic {
     Device *device; // Borrowed
     Service *service; // Borrowed
     GDBusConnection *connection; // Borrowed
     const char *path; // Owned
-    const char *uuid; // Owned
+    const char *uuid; // Interned
     const char *service_path; // Owned
     gboolean notifying;
     GList *flags; // Owned
     guint properties;
     GList *descriptors; // Owned
     guint mtu;
-
-    guint characteristic_prop_changed;
+    const guint8 *value_view_data; // Borrowed, only valid while a read/notify callback runs
+    gsize value_view_len;
+    int notify_fd;
+    guint notify_fd_source;
+    int write_fd;
+    GQueue *write_queue; // Owned
+    guint writes_in_flight;
+    guint write_queue_depth;
+    ReadStream *read_stream; // Owned while a streaming read runs
+    WriteStream *write_stream; // Owned while a streaming write runs
+
+    OnWriteDrainedCallback on_write_drained_callback;
     OnNotifyingStateChangedCallback notify_state_callback;
     OnReadCallback on_read_callback;
     OnWriteCallback on_write_callback;
@@ -72,15 +125,57 @@ Characteristic *binc_characteristic_create(Device *device, const char *path) {
     characteristic->connection = binc_device_get_dbus_connection(device);
     characteristic->path = g_strdup(path);
     characteristic->mtu = 23;
+    characteristic->notify_fd = -1;
+    characteristic->write_fd = -1;
+    characteristic->write_queue = g_queue_new();
+    characteristic->write_queue_depth = DEFAULT_WRITE_QUEUE_DEPTH;
     return characteristic;
 }
 
+static void binc_internal_close_notify_fd(Characteristic *characteristic) {
+    if (characteristic->notify_fd_source != 0) {
+        binc_source_remove(characteristic->notify_fd_source);
+        characteristic->notify_fd_source = 0;
+    }
+
+    if (characteristic->notify_fd != -1) {
+        close(characteristic->notify_fd);
+        characteristic->notify_fd = -1;
+    }
+}
+
+static void binc_internal_close_write_fd(Characteristic *characteristic) {
+    if (characteristic->write_fd != -1) {
+        close(characteristic->write_fd);
+        characteristic->write_fd = -1;
+    }
+}
+
 void binc_characteristic_free(Characteristic *characteristic) {
     g_assert(characteristic != NULL);
 
-    if (characteristic->characteristic_prop_changed != 0) {
-        g_dbus_connection_signal_unsubscribe(characteristic->connection, characteristic->characteristic_prop_changed);
-        characteristic->characteristic_prop_changed = 0;
+    binc_internal_close_notify_fd(characteristic);
+    binc_internal_close_write_fd(characteristic);
+
+    if (characteristic->read_stream != NULL) {
+        g_byte_array_unref(characteristic->read_stream->buffer);
+        g_free(characteristic->read_stream);
+        characteristic->read_stream = NULL;
+    }
+
+    if (characteristic->write_stream != NULL) {
+        if (characteristic->write_stream->error != NULL) {
+            g_error_free(characteristic->write_stream->error);
+        }
+        g_byte_array_unref(characteristic->write_stream->data);
+        g_free(characteristic->write_stream);
+        characteristic->write_stream = NULL;
+    }
+
+    if (characteristic->write_queue != NULL) {
+        binc_internal_stats_add(BINC_STATS_WRITE_QUEUE_DEPTH, -((gint) g_queue_get_length(characteristic->write_queue)));
+        g_queue_free_full(characteristic->write_queue, (GDestroyNotify) g_byte_array_unref);
+        characteristic->write_queue = NULL;
     }
 
     if (characteristic->flags != NULL) {
@@ -93,7 +188,6 @@ void binc_characteristic_free(Characteristic *characteristic) {
         characteristic->descriptors = NULL;
     }
 
-    g_free((char *) characteristic->uuid);
     characteristic->uuid = NULL;
 
     g_free((char *) characteristic->path);
@@ -146,12 +240,17 @@ static void binc_internal_char_read_cb(__attribute__((unused)) GObject *source_o
         g_assert(g_str_equal(g_variant_get_type_string(value), "(ay)"));
         innerArray = g_variant_get_child_value(value, 0);
         byteArray = g_variant_get_byte_array(innerArray);
+        characteristic->value_view_data = byteArray->data;
+        characteristic->value_view_len = byteArray->len;
     }
 
     if (characteristic->on_read_callback != NULL) {
         characteristic->on_read_callback(characteristic->device, characteristic, byteArray, error);
     }
 
+    characteristic->value_view_data = NULL;
+    characteristic->value_view_len = 0;
+
     if (byteArray != NULL) {
         g_byte_array_free(byteArray, FALSE);
     }
@@ -183,6 +282,8 @@ void binc_characteristic_read(Characteristic *characteristic) {
     GVariant *options = g_variant_builder_end(builder);
     g_variant_builder_unref(builder);
 
+    binc_internal_stats_add(BINC_STATS_CHAR_READS, 1);
+    binc_internal_stats_add(BINC_STATS_DBUS_CALLS, 1);
     g_dbus_connection_call(characteristic->connection,
                            BLUEZ_DBUS,
                            characteristic->path,
@@ -239,9 +340,28 @@ void binc_characteristic_write(Characteristic *characteristic, const GByteArray
     g_assert(byteArray->len > 0);
     g_assert(binc_characteristic_supports_write(characteristic, writeType));
 
-    GString *byteArrayStr = g_byte_array_as_hex(byteArray);
-    log_debug(TAG, "writing <%s> to <%s>", byteArrayStr->str, characteristic->uuid);
-    g_string_free(byteArrayStr, TRUE);
+    log_debug_hex(TAG, byteArray, "writing <%s> to <%s>", characteristic->uuid);
+
+    binc_internal_stats_add(BINC_STATS_CHAR_WRITES, 1);
+
+    // Use the acquired fd if we have one, skipping D-Bus marshalling entirely
+    if (writeType == WITHOUT_RESPONSE && characteristic->write_fd != -1) {
+        GError *error = NULL;
+        ssize_t bytes_written = write(characteristic->write_fd, byteArray->data, byteArray->len);
+        if (bytes_written < 0) {
+            error = g_error_new(G_IO_ERROR, g_io_error_from_errno(errno),
+                                "failed to write to acquired fd for <%s>", characteristic->uuid);
+        }
+
+        if (characteristic->on_write_callback != NULL) {
+            characteristic->on_write_callback(characteristic->device, characteristic, byteArray, error);
+        }
+
+        if (error != NULL) {
+            g_clear_error(&error);
+        }
+        return;
+    }
 
     GVariant *value = g_variant_new_fixed_array(G_VARIANT_TYPE_BYTE, byteArray->data, byteArray->len, sizeof(guint8));
 
@@ -257,6 +377,7 @@ void binc_characteristic_write(Characteristic *characteristic, const GByteArray
     GVariant *options = g_variant_builder_end(optionsBuilder);
     g_variant_builder_unref(optionsBuilder);
 
+    binc_internal_stats_add(BINC_STATS_DBUS_CALLS, 1);
     g_dbus_connection_call(characteristic->connection,
                            BLUEZ_DBUS,
                            characteristic->path,
@@ -271,17 +392,415 @@ void binc_characteristic_write(Characteristic *characteristic, const GByteArray
                            writeData);
 }
 
-static void binc_internal_signal_characteristic_changed(__attribute__((unused)) GDBusConnection *conn,
-                                                        __attribute__((unused)) const gchar *sender,
-                                                        __attribute__((unused)) const gchar *path,
-                                                        __attribute__((unused)) const gchar *interface,
-                                                        __attribute__((unused)) const gchar *signal,
-                                                        GVariant *parameters,
-                                                        void *user_data) {
+void binc_characteristic_write_take(Characteristic *characteristic, guint8 *data, gsize len,
+                                    GDestroyNotify free_func, WriteType writeType) {
+    g_assert(characteristic != NULL);
+    g_assert(data != NULL);
+    g_assert(len > 0);
+    g_assert(binc_characteristic_supports_write(characteristic, writeType));
+
+    GByteArray view = {data, (guint) len};
+    log_debug_hex(TAG, &view, "writing <%s> to <%s>", characteristic->uuid);
+
+    binc_internal_stats_add(BINC_STATS_CHAR_WRITES, 1);
+
+    // Use the acquired fd if we have one, skipping D-Bus marshalling entirely
+    if (writeType == WITHOUT_RESPONSE && characteristic->write_fd != -1) {
+        GError *error = NULL;
+        ssize_t bytes_written = write(characteristic->write_fd, data, len);
+        if (bytes_written < 0) {
+            error = g_error_new(G_IO_ERROR, g_io_error_from_errno(errno),
+                                "failed to write to acquired fd for <%s>", characteristic->uuid);
+        }
+
+        if (characteristic->on_write_callback != NULL) {
+            characteristic->on_write_callback(characteristic->device, characteristic, &view, error);
+        }
+
+        if (error != NULL) {
+            g_clear_error(&error);
+        }
+        if (free_func != NULL) {
+            free_func(data);
+        }
+        return;
+    }
+
+    // The serialized form of 'ay' is the bytes themselves, so the variant can
+    // wrap the caller's memory directly and release it through free_func
+    GVariant *value = g_variant_new_from_data(G_VARIANT_TYPE("ay"), data, len, TRUE, free_func, data);
+
+    WriteData *writeData = g_new0(WriteData, 1);
+    writeData->value = g_variant_ref_sink(value);
+    writeData->characteristic = characteristic;
+
+    guint16 offset = 0;
+    const char *writeTypeString = writeType == WITH_RESPONSE ? "request" : "command";
+    GVariantBuilder *optionsBuilder = g_variant_builder_new(G_VARIANT_TYPE("a{sv}"));
+    g_variant_builder_add(optionsBuilder, "{sv}", "offset", g_variant_new_uint16(offset));
+    g_variant_builder_add(optionsBuilder, "{sv}", "type", g_variant_new_string(writeTypeString));
+    GVariant *options = g_variant_builder_end(optionsBuilder);
+    g_variant_builder_unref(optionsBuilder);
+
+    binc_internal_stats_add(BINC_STATS_DBUS_CALLS, 1);
+    g_dbus_connection_call(characteristic->connection,
+                           BLUEZ_DBUS,
+                           characteristic->path,
+                           INTERFACE_CHARACTERISTIC,
+                           CHARACTERISTIC_METHOD_WRITE_VALUE,
+                           g_variant_new("(@ay@a{sv})", value, options),
+                           NULL,
+                           G_DBUS_CALL_FLAGS_NONE,
+                           -1,
+                           NULL,
+                           (GAsyncReadyCallback) binc_internal_char_write_cb,
+                           writeData);
+}
+
+static void binc_internal_read_stream_next(ReadStream *stream);
+
+static void binc_internal_read_stream_finish(ReadStream *stream, const GError *error) {
+    Characteristic *characteristic = stream->characteristic;
+    characteristic->read_stream = NULL;
+
+    if (stream->complete_callback != NULL) {
+        stream->complete_callback(characteristic->device, characteristic,
+                                  error == NULL ? stream->buffer : NULL, error);
+    }
+    g_byte_array_unref(stream->buffer);
+    g_free(stream);
+}
+
+static void binc_internal_read_stream_cb(__attribute__((unused)) GObject *source_object,
+                                         GAsyncResult *res,
+                                         gpointer user_data) {
+    ReadStream *stream = (ReadStream *) user_data;
+    Characteristic *characteristic = stream->characteristic;
+    g_assert(characteristic != NULL);
+
+    GError *error = NULL;
+    GVariant *value = g_dbus_connection_call_finish(characteristic->connection, res, &error);
+    if (error != NULL) {
+        log_debug(TAG, "streaming read of <%s> failed (error %d: %s)", characteristic->uuid,
+                  error->code, error->message);
+        binc_internal_read_stream_finish(stream, error);
+        g_clear_error(&error);
+        return;
+    }
+
+    GVariant *innerArray = g_variant_get_child_value(value, 0);
+    gsize chunk_length = 0;
+    const guint8 *chunk = g_variant_get_fixed_array(innerArray, &chunk_length, sizeof(guint8));
+    if (chunk_length > 0) {
+        g_byte_array_append(stream->buffer, chunk, (guint) chunk_length);
+    }
+    g_variant_unref(innerArray);
+    g_variant_unref(value);
+
+    if (stream->progress_callback != NULL) {
+        stream->progress_callback(characteristic->device, characteristic, stream->buffer->len, 0);
+    }
+
+    // A chunk smaller than the read payload means the value is exhausted
+    if (chunk_length < characteristic->mtu - ATT_READ_HEADER_SIZE) {
+        binc_internal_read_stream_finish(stream, NULL);
+    } else {
+        binc_internal_read_stream_next(stream);
+    }
+}
+
+static void binc_internal_read_stream_next(ReadStream *stream) {
+    Characteristic *characteristic = stream->characteristic;
+
+    GVariantBuilder *builder = g_variant_builder_new(G_VARIANT_TYPE("a{sv}"));
+    g_variant_builder_add(builder, "{sv}", "offset", g_variant_new_uint16((guint16) stream->buffer->len));
+    GVariant *options = g_variant_builder_end(builder);
+    g_variant_builder_unref(builder);
+
+    binc_internal_stats_add(BINC_STATS_CHAR_READS, 1);
+    binc_internal_stats_add(BINC_STATS_DBUS_CALLS, 1);
+    g_dbus_connection_call(characteristic->connection,
+                           BLUEZ_DBUS,
+                           characteristic->path,
+                           INTERFACE_CHARACTERISTIC,
+                           CHARACTERISTIC_METHOD_READ_VALUE,
+                           g_variant_new("(@a{sv})", options),
+                           G_VARIANT_TYPE("(ay)"),
+                           G_DBUS_CALL_FLAGS_NONE,
+                           -1,
+                           NULL,
+                           (GAsyncReadyCallback) binc_internal_read_stream_cb,
+                           stream);
+}
+
+void binc_characteristic_read_stream(Characteristic *characteristic,
+                                     OnStreamProgressCallback progress_callback,
+                                     OnReadStreamCompleteCallback complete_callback) {
+    g_assert(characteristic != NULL);
+    g_assert((characteristic->properties & GATT_CHR_PROP_READ) > 0);
+    g_assert(characteristic->read_stream == NULL);
+
+    log_debug(TAG, "streaming read of <%s>", characteristic->uuid);
+
+    ReadStream *stream = g_new0(ReadStream, 1);
+    stream->characteristic = characteristic;
+    stream->buffer = g_byte_array_new();
+    stream->progress_callback = progress_callback;
+    stream->complete_callback = complete_callback;
+    characteristic->read_stream = stream;
+
+    binc_internal_read_stream_next(stream);
+}
+
+static void binc_internal_write_stream_pump(WriteStream *stream);
+
+static void binc_internal_write_stream_finish(WriteStream *stream) {
+    Characteristic *characteristic = stream->characteristic;
+    characteristic->write_stream = NULL;
+
+    if (stream->complete_callback != NULL) {
+        stream->complete_callback(characteristic->device, characteristic, stream->error);
+    }
+    if (stream->error != NULL) {
+        g_error_free(stream->error);
+    }
+    g_byte_array_unref(stream->data);
+    g_free(stream);
+}
+
+static void binc_internal_write_stream_cb(__attribute__((unused)) GObject *source_object,
+                                          GAsyncResult *res,
+                                          gpointer user_data) {
+    WriteStreamChunk *chunk = (WriteStreamChunk *) user_data;
+    WriteStream *stream = chunk->stream;
+    Characteristic *characteristic = stream->characteristic;
+    g_assert(characteristic != NULL);
+
+    GError *error = NULL;
+    GVariant *value = g_dbus_connection_call_finish(characteristic->connection, res, &error);
+    if (value != NULL) {
+        g_variant_unref(value);
+    }
+
+    g_assert(stream->chunks_in_flight > 0);
+    stream->chunks_in_flight--;
+
+    if (error != NULL) {
+        log_debug(TAG, "streaming write to <%s> failed (error %d: %s)", characteristic->uuid,
+                  error->code, error->message);
+        // Keep the first error, stop sending and wait for the in-flight chunks
+        if (stream->error == NULL) {
+            stream->error = error;
+        } else {
+            g_clear_error(&error);
+        }
+    } else {
+        stream->bytes_acked += chunk->size;
+        if (stream->progress_callback != NULL) {
+            stream->progress_callback(characteristic->device, characteristic,
+                                      stream->bytes_acked, stream->data->len);
+        }
+    }
+    g_free(chunk);
+
+    if (stream->error != NULL) {
+        if (stream->chunks_in_flight == 0) {
+            binc_internal_write_stream_finish(stream);
+        }
+        return;
+    }
+
+    if (stream->bytes_acked == stream->data->len && stream->chunks_in_flight == 0) {
+        binc_internal_write_stream_finish(stream);
+    } else {
+        binc_internal_write_stream_pump(stream);
+    }
+}
+
+static void binc_internal_write_stream_pump(WriteStream *stream) {
+    Characteristic *characteristic = stream->characteristic;
+    guint max_payload = characteristic->mtu - ATT_WRITE_HEADER_SIZE;
+
+    while (stream->error == NULL &&
+           stream->chunks_in_flight < characteristic->write_queue_depth &&
+           stream->next_offset < stream->data->len) {
+        gsize size = MIN(stream->data->len - stream->next_offset, (gsize) max_payload);
+        GVariant *value = g_variant_new_fixed_array(G_VARIANT_TYPE_BYTE,
+                                                    stream->data->data + stream->next_offset,
+                                                    size, sizeof(guint8));
+
+        // Each chunk carries its own offset, so chunks can be in flight concurrently
+        GVariantBuilder *optionsBuilder = g_variant_builder_new(G_VARIANT_TYPE("a{sv}"));
+        g_variant_builder_add(optionsBuilder, "{sv}", "offset", g_variant_new_uint16((guint16) stream->next_offset));
+        g_variant_builder_add(optionsBuilder, "{sv}", "type", g_variant_new_string("request"));
+        GVariant *options = g_variant_builder_end(optionsBuilder);
+        g_variant_builder_unref(optionsBuilder);
+
+        WriteStreamChunk *chunk = g_new0(WriteStreamChunk, 1);
+        chunk->stream = stream;
+        chunk->size = size;
+        stream->chunks_in_flight++;
+        stream->next_offset += size;
+
+        binc_internal_stats_add(BINC_STATS_CHAR_WRITES, 1);
+        binc_internal_stats_add(BINC_STATS_DBUS_CALLS, 1);
+        g_dbus_connection_call(characteristic->connection,
+                               BLUEZ_DBUS,
+                               characteristic->path,
+                               INTERFACE_CHARACTERISTIC,
+                               CHARACTERISTIC_METHOD_WRITE_VALUE,
+                               g_variant_new("(@ay@a{sv})", value, options),
+                               NULL,
+                               G_DBUS_CALL_FLAGS_NONE,
+                               -1,
+                               NULL,
+                               (GAsyncReadyCallback) binc_internal_write_stream_cb,
+                               chunk);
+    }
+}
+
+void binc_characteristic_write_stream(Characteristic *characteristic, const GByteArray *byteArray,
+                                      OnStreamProgressCallback progress_callback,
+                                      OnWriteStreamCompleteCallback complete_callback) {
+    g_assert(characteristic != NULL);
+    g_assert(byteArray != NULL);
+    g_assert(byteArray->len > 0);
+    g_assert(binc_characteristic_supports_write(characteristic, WITH_RESPONSE));
+    g_assert(characteristic->write_stream == NULL);
+
+    log_debug(TAG, "streaming write of %u bytes to <%s>", byteArray->len, characteristic->uuid);
+
+    WriteStream *stream = g_new0(WriteStream, 1);
+    stream->characteristic = characteristic;
+    stream->data = g_byte_array_sized_new(byteArray->len);
+    g_byte_array_append(stream->data, byteArray->data, byteArray->len);
+    stream->progress_callback = progress_callback;
+    stream->complete_callback = complete_callback;
+    characteristic->write_stream = stream;
+
+    binc_internal_write_stream_pump(stream);
+}
+
+static void binc_internal_pump_write_queue(Characteristic *characteristic);
 
+static void binc_internal_char_write_queued_cb(__attribute__((unused)) GObject *source_object,
+                                               GAsyncResult *res,
+                                               gpointer user_data) {
     Characteristic *characteristic = (Characteristic *) user_data;
     g_assert(characteristic != NULL);
 
+    GError *error = NULL;
+    GVariant *value = g_dbus_connection_call_finish(characteristic->connection, res, &error);
+    if (value != NULL) {
+        g_variant_unref(value);
+    }
+
+    if (error != NULL) {
+        log_debug(TAG, "failed to call '%s' (error %d: %s)", CHARACTERISTIC_METHOD_WRITE_VALUE,
+                  error->code, error->message);
+        g_clear_error(&error);
+    }
+
+    characteristic->writes_in_flight--;
+    binc_internal_pump_write_queue(characteristic);
+}
+
+static void binc_internal_pump_write_queue(Characteristic *characteristic) {
+    g_assert(characteristic != NULL);
+
+    while (characteristic->writes_in_flight < characteristic->write_queue_depth &&
+           !g_queue_is_empty(characteristic->write_queue)) {
+        GByteArray *byteArray = g_queue_pop_head(characteristic->write_queue);
+        binc_internal_stats_add(BINC_STATS_WRITE_QUEUE_DEPTH, -1);
+        binc_internal_stats_add(BINC_STATS_CHAR_WRITES, 1);
+
+        if (characteristic->write_fd != -1) {
+            // Acquired fd: the socket buffer provides the flow control
+            if (write(characteristic->write_fd, byteArray->data, byteArray->len) < 0) {
+                log_debug(TAG, "failed to write to acquired fd for <%s>", characteristic->uuid);
+            }
+            g_byte_array_unref(byteArray);
+            continue;
+        }
+
+        GVariant *value = g_variant_new_fixed_array(G_VARIANT_TYPE_BYTE, byteArray->data,
+                                                    byteArray->len, sizeof(guint8));
+        g_byte_array_unref(byteArray);
+
+        GVariantBuilder *optionsBuilder = g_variant_builder_new(G_VARIANT_TYPE("a{sv}"));
+        g_variant_builder_add(optionsBuilder, "{sv}", "type", g_variant_new_string("command"));
+        GVariant *options = g_variant_builder_end(optionsBuilder);
+        g_variant_builder_unref(optionsBuilder);
+
+        characteristic->writes_in_flight++;
+        binc_internal_stats_add(BINC_STATS_DBUS_CALLS, 1);
+        g_dbus_connection_call(characteristic->connection,
+                               BLUEZ_DBUS,
+                               characteristic->path,
+                               INTERFACE_CHARACTERISTIC,
+                               CHARACTERISTIC_METHOD_WRITE_VALUE,
+                               g_variant_new("(@ay@a{sv})", value, options),
+                               NULL,
+                               G_DBUS_CALL_FLAGS_NONE,
+                               -1,
+                               NULL,
+                               (GAsyncReadyCallback) binc_internal_char_write_queued_cb,
+                               characteristic);
+    }
+
+    if (characteristic->writes_in_flight == 0 && g_queue_is_empty(characteristic->write_queue)) {
+        if (characteristic->on_write_drained_callback != NULL) {
+            characteristic->on_write_drained_callback(characteristic->device, characteristic);
+        }
+    }
+}
+
+gboolean binc_characteristic_write_queued(Characteristic *characteristic, const GByteArray *byteArray) {
+    g_assert(characteristic != NULL);
+    g_assert(byteArray != NULL);
+    g_assert(byteArray->len > 0);
+
+    if (!binc_characteristic_supports_write(characteristic, WITHOUT_RESPONSE)) return FALSE;
+
+    guint max_payload = characteristic->mtu - ATT_WRITE_HEADER_SIZE;
+
+    guint offset = 0;
+    while (offset < byteArray->len) {
+        guint chunk = MIN(byteArray->len - offset, max_payload);
+
+        // Coalesce into the last queued buffer as long as it fits the MTU
+        GByteArray *tail = g_queue_peek_tail(characteristic->write_queue);
+        if (tail != NULL && tail->len + chunk <= max_payload) {
+            g_byte_array_append(tail, byteArray->data + offset, chunk);
+        } else {
+            GByteArray *copy = g_byte_array_sized_new(max_payload);
+            g_byte_array_append(copy, byteArray->data + offset, chunk);
+            g_queue_push_tail(characteristic->write_queue, copy);
+            binc_internal_stats_add(BINC_STATS_WRITE_QUEUE_DEPTH, 1);
+        }
+        offset += chunk;
+    }
+
+    binc_internal_pump_write_queue(characteristic);
+    return TRUE;
+}
+
+void binc_characteristic_set_write_queue_depth(Characteristic *characteristic, guint depth) {
+    g_assert(characteristic != NULL);
+    g_assert(depth > 0);
+    characteristic->write_queue_depth = depth;
+}
+
+void binc_characteristic_set_write_drained_cb(Characteristic *characteristic, OnWriteDrainedCallback callback) {
+    g_assert(characteristic != NULL);
+    g_assert(callback != NULL);
+    characteristic->on_write_drained_callback = callback;
+}
+
+void binc_internal_characteristic_handle_properties_changed(Characteristic *characteristic, GVariant *parameters) {
+    g_assert(characteristic != NULL);
+    g_assert(parameters != NULL);
+
     GVariantIter *properties_changed = NULL;
     GVariantIter *properties_invalidated = NULL;
     const char *iface = NULL;
@@ -298,24 +817,21 @@ static void binc_internal_signal_characteristic_changed(__attribute__((unused))
             if (characteristic->notify_state_callback != NULL) {
                 characteristic->notify_state_callback(characteristic->device, characteristic, NULL);
             }
-
-            if (characteristic->notifying == FALSE) {
-                if (characteristic->characteristic_prop_changed != 0) {
-                    g_dbus_connection_signal_unsubscribe(characteristic->connection,
-                                                         characteristic->characteristic_prop_changed);
-                    characteristic->characteristic_prop_changed = 0;
-                }
-            }
         } else if (g_str_equal(property_name, CHARACTERISTIC_PROPERTY_VALUE)) {
-            GByteArray *byteArray = g_variant_get_byte_array(property_value);
-            GString *result = g_byte_array_as_hex(byteArray);
-            log_debug(TAG, "notification <%s> on <%s>", result->str, characteristic->uuid);
-            g_string_free(result, TRUE);
+            // Wrap the variant's data without copying, the array is only valid during the callback
+            gsize data_length = 0;
+            guint8 *data = (guint8 *) g_variant_get_fixed_array(property_value, &data_length, sizeof(guint8));
+            GByteArray byteArray = {data, (guint) data_length};
 
+            log_debug_hex(TAG, &byteArray, "notification <%s> on <%s>", characteristic->uuid);
+
+            characteristic->value_view_data = data;
+            characteristic->value_view_len = data_length;
             if (characteristic->on_notify_callback != NULL) {
-                characteristic->on_notify_callback(characteristic->device, characteristic, byteArray);
+                characteristic->on_notify_callback(characteristic->device, characteristic, &byteArray);
             }
-            g_byte_array_free(byteArray, FALSE);
+            characteristic->value_view_data = NULL;
+            characteristic->value_view_len = 0;
         }
     }
 
@@ -350,27 +866,11 @@ static void binc_internal_char_start_notify_cb(__attribute__((unused)) GObject *
     }
 }
 
-static void register_for_properties_changed_signal(Characteristic *characteristic) {
-    if (characteristic->characteristic_prop_changed == 0) {
-        characteristic->characteristic_prop_changed = g_dbus_connection_signal_subscribe(characteristic->connection,
-                                                                                         BLUEZ_DBUS,
-                                                                                         "org.freedesktop.DBus.Properties",
-                                                                                         "PropertiesChanged",
-                                                                                         characteristic->path,
-                                                                                         INTERFACE_CHARACTERISTIC,
-                                                                                         G_DBUS_SIGNAL_FLAGS_NONE,
-                                                                                         binc_internal_signal_characteristic_changed,
-                                                                                         characteristic,
-                                                                                         NULL);
-    }
-}
-
 void binc_characteristic_start_notify(Characteristic *characteristic) {
     g_assert(characteristic != NULL);
     g_assert(binc_characteristic_supports_notify(characteristic));
 
     log_debug(TAG, "start notify for <%s>", characteristic->uuid);
-    register_for_properties_changed_signal(characteristic);
 
     g_dbus_connection_call(characteristic->connection,
                            BLUEZ_DBUS,
@@ -406,11 +906,193 @@ static void binc_internal_char_stop_notify_cb(GObject *source_object, GAsyncResu
     }
 }
 
+static gboolean binc_internal_notify_fd_readable(gint fd, GIOCondition condition, gpointer user_data) {
+    Characteristic *characteristic = (Characteristic *) user_data;
+    g_assert(characteristic != NULL);
+
+    if (condition & G_IO_IN) {
+        guint8 buffer[MAX_ATT_MTU];
+        ssize_t bytes_read = read(fd, buffer, sizeof(buffer));
+        if (bytes_read > 0) {
+            // Wrap the buffer without copying, the array is only valid during the callback
+            GByteArray byteArray = {buffer, (guint) bytes_read};
+
+            log_debug_hex(TAG, &byteArray, "notification <%s> on <%s>", characteristic->uuid);
+
+            characteristic->value_view_data = buffer;
+            characteristic->value_view_len = (gsize) bytes_read;
+            if (characteristic->on_notify_callback != NULL) {
+                characteristic->on_notify_callback(characteristic->device, characteristic, &byteArray);
+            }
+            characteristic->value_view_data = NULL;
+            characteristic->value_view_len = 0;
+            return G_SOURCE_CONTINUE;
+        }
+    }
+
+    // Error or hang-up: bluetoothd closed the fd so notifications have stopped
+    log_debug(TAG, "acquired notify fd closed for <%s>", characteristic->uuid);
+    characteristic->notify_fd_source = 0;
+    binc_internal_close_notify_fd(characteristic);
+    characteristic->notifying = FALSE;
+
+    if (characteristic->notify_state_callback != NULL) {
+        characteristic->notify_state_callback(characteristic->device, characteristic, NULL);
+    }
+    return G_SOURCE_REMOVE;
+}
+
+static void binc_internal_char_acquire_notify_cb(__attribute__((unused)) GObject *source_object,
+                                                 GAsyncResult *res,
+                                                 gpointer user_data) {
+
+    Characteristic *characteristic = (Characteristic *) user_data;
+    g_assert(characteristic != NULL);
+
+    GError *error = NULL;
+    GUnixFDList *fd_list = NULL;
+    GVariant *value = g_dbus_connection_call_with_unix_fd_list_finish(characteristic->connection,
+                                                                      &fd_list, res, &error);
+    if (value != NULL) {
+        gint32 fd_index = 0;
+        guint16 mtu = 0;
+        g_variant_get(value, "(hq)", &fd_index, &mtu);
+
+        characteristic->notify_fd = g_unix_fd_list_get(fd_list, fd_index, &error);
+        if (characteristic->notify_fd >= 0) {
+            characteristic->mtu = mtu;
+            characteristic->notify_fd_source = binc_unix_fd_add(characteristic->notify_fd,
+                                                             G_IO_IN | G_IO_HUP | G_IO_ERR,
+                                                             binc_internal_notify_fd_readable,
+                                                             characteristic);
+            characteristic->notifying = TRUE;
+            log_debug(TAG, "acquired notify fd (mtu=%u) for <%s>", mtu, characteristic->uuid);
+
+            if (characteristic->notify_state_callback != NULL) {
+                characteristic->notify_state_callback(characteristic->device, characteristic, NULL);
+            }
+        }
+        g_variant_unref(value);
+    }
+
+    if (fd_list != NULL) {
+        g_object_unref(fd_list);
+    }
+
+    if (error != NULL) {
+        log_debug(TAG, "failed to call '%s' (error %d: %s)", CHARACTERISTIC_METHOD_ACQUIRE_NOTIFY, error->code,
+                  error->message);
+        if (characteristic->notify_state_callback != NULL) {
+            characteristic->notify_state_callback(characteristic->device, characteristic, error);
+        }
+        g_clear_error(&error);
+    }
+}
+
+void binc_characteristic_acquire_notify(Characteristic *characteristic) {
+    g_assert(characteristic != NULL);
+    g_assert(binc_characteristic_supports_notify(characteristic));
+
+    if (characteristic->notify_fd != -1) return;
+
+    log_debug(TAG, "acquire notify for <%s>", characteristic->uuid);
+
+    GVariantBuilder *builder = g_variant_builder_new(G_VARIANT_TYPE("a{sv}"));
+    GVariant *options = g_variant_builder_end(builder);
+    g_variant_builder_unref(builder);
+
+    g_dbus_connection_call_with_unix_fd_list(characteristic->connection,
+                                             BLUEZ_DBUS,
+                                             characteristic->path,
+                                             INTERFACE_CHARACTERISTIC,
+                                             CHARACTERISTIC_METHOD_ACQUIRE_NOTIFY,
+                                             g_variant_new("(@a{sv})", options),
+                                             G_VARIANT_TYPE("(hq)"),
+                                             G_DBUS_CALL_FLAGS_NONE,
+                                             -1,
+                                             NULL,
+                                             NULL,
+                                             (GAsyncReadyCallback) binc_internal_char_acquire_notify_cb,
+                                             characteristic);
+}
+
+static void binc_internal_char_acquire_write_cb(__attribute__((unused)) GObject *source_object,
+                                                GAsyncResult *res,
+                                                gpointer user_data) {
+
+    Characteristic *characteristic = (Characteristic *) user_data;
+    g_assert(characteristic != NULL);
+
+    GError *error = NULL;
+    GUnixFDList *fd_list = NULL;
+    GVariant *value = g_dbus_connection_call_with_unix_fd_list_finish(characteristic->connection,
+                                                                      &fd_list, res, &error);
+    if (value != NULL) {
+        gint32 fd_index = 0;
+        guint16 mtu = 0;
+        g_variant_get(value, "(hq)", &fd_index, &mtu);
+
+        characteristic->write_fd = g_unix_fd_list_get(fd_list, fd_index, &error);
+        if (characteristic->write_fd >= 0) {
+            characteristic->mtu = mtu;
+            log_debug(TAG, "acquired write fd (mtu=%u) for <%s>", mtu, characteristic->uuid);
+        }
+        g_variant_unref(value);
+    }
+
+    if (fd_list != NULL) {
+        g_object_unref(fd_list);
+    }
+
+    if (error != NULL) {
+        log_debug(TAG, "failed to call '%s' (error %d: %s)", CHARACTERISTIC_METHOD_ACQUIRE_WRITE, error->code,
+                  error->message);
+        g_clear_error(&error);
+    }
+}
+
+void binc_characteristic_acquire_write(Characteristic *characteristic) {
+    g_assert(characteristic != NULL);
+    g_assert(binc_characteristic_supports_write(characteristic, WITHOUT_RESPONSE));
+
+    if (characteristic->write_fd != -1) return;
+
+    log_debug(TAG, "acquire write for <%s>", characteristic->uuid);
+
+    GVariantBuilder *builder = g_variant_builder_new(G_VARIANT_TYPE("a{sv}"));
+    GVariant *options = g_variant_builder_end(builder);
+    g_variant_builder_unref(builder);
+
+    g_dbus_connection_call_with_unix_fd_list(characteristic->connection,
+                                             BLUEZ_DBUS,
+                                             characteristic->path,
+                                             INTERFACE_CHARACTERISTIC,
+                                             CHARACTERISTIC_METHOD_ACQUIRE_WRITE,
+                                             g_variant_new("(@a{sv})", options),
+                                             G_VARIANT_TYPE("(hq)"),
+                                             G_DBUS_CALL_FLAGS_NONE,
+                                             -1,
+                                             NULL,
+                                             NULL,
+                                             (GAsyncReadyCallback) binc_internal_char_acquire_write_cb,
+                                             characteristic);
+}
+
 void binc_characteristic_stop_notify(Characteristic *characteristic) {
     g_assert(characteristic != NULL);
     g_assert((characteristic->properties & GATT_CHR_PROP_INDICATE) > 0 ||
              (characteristic->properties & GATT_CHR_PROP_NOTIFY) > 0);
 
+    // Notifications acquired via fd are stopped by closing the fd
+    if (characteristic->notify_fd != -1) {
+        binc_internal_close_notify_fd(characteristic);
+        characteristic->notifying = FALSE;
+        if (characteristic->notify_state_callback != NULL) {
+            characteristic->notify_state_callback(characteristic->device, characteristic, NULL);
+        }
+        return;
+    }
+
     g_dbus_connection_call(characteristic->connection,
                            BLUEZ_DBUS,
                            characteristic->path,
@@ -454,10 +1136,6 @@ void binc_characteristic_set_notifying_state_change_cb(Characteristic *character
 void binc_characteristic_set_notifying(Characteristic *characteristic, gboolean notifying) {
     g_assert(characteristic != NULL);
     characteristic->notifying = notifying;
-
-    if(characteristic->notifying) {
-        register_for_properties_changed_signal(characteristic);
-    }
 }
 
 const char *binc_characteristic_get_uuid(const Characteristic *characteristic) {
@@ -469,8 +1147,7 @@ void binc_characteristic_set_uuid(Characteristic *characteristic, const char *uu
     g_assert(characteristic != NULL);
     g_assert(uuid != NULL);
 
-    g_free((char *) characteristic->uuid);
-    characteristic->uuid = g_strdup(uuid);
+    characteristic->uuid = binc_uuid_intern_string(uuid);
 }
 
 void binc_characteristic_set_mtu(Characteristic *characteristic, guint mtu) {
@@ -478,6 +1155,19 @@ void binc_characteristic_set_mtu(Characteristic *characteristic, guint mtu) {
     characteristic->mtu = mtu;
 }
 
+guint binc_characteristic_get_mtu(const Characteristic *characteristic) {
+    g_assert(characteristic != NULL);
+    return characteristic->mtu;
+}
+
+const guint8 *binc_characteristic_get_value_view(const Characteristic *characteristic, gsize *length) {
+    g_assert(characteristic != NULL);
+    g_assert(length != NULL);
+
+    *length = characteristic->value_view_len;
+    return characteristic->value_view_data;
+}
+
 Device *binc_characteristic_get_device(const Characteristic *characteristic) {
     g_assert(characteristic != NULL);
     return characteristic->device;
@@ -597,9 +1287,10 @@ Descriptor *binc_characteristic_get_descriptor(const Characteristic *characteris
     g_assert(is_valid_uuid(desc_uuid));
 
     if (characteristic->descriptors != NULL) {
+        const char *interned_uuid = binc_uuid_intern_string(desc_uuid);
         for (GList *iterator = characteristic->descriptors; iterator; iterator = iterator->next) {
             Descriptor *descriptor = (Descriptor *) iterator->data;
-            if (g_str_equal(desc_uuid, binc_descriptor_get_uuid(descriptor))) {
+            if (interned_uuid == binc_descriptor_get_uuid(descriptor)) {
                 return descriptor;
             }
         }
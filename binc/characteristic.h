@@ -73,13 +73,122 @@ typedef void (*OnReadCallback)(Device *device, Characteristic *characteristic, c
 
 typedef void (*OnWriteCallback)(Device *device, Characteristic *characteristic, const GByteArray *byteArray, const GError *error);
 
+typedef void (*OnWriteDrainedCallback)(Device *device, Characteristic *characteristic);
+
+/**
+ * Progress of a streaming transfer. 'bytes_total' is 0 for streaming reads,
+ * where the total length is not known until the read completes.
+ */
+typedef void (*OnStreamProgressCallback)(Device *device, Characteristic *characteristic,
+                                         gsize bytes_transferred, gsize bytes_total);
+
+typedef void (*OnReadStreamCompleteCallback)(Device *device, Characteristic *characteristic,
+                                             const GByteArray *byteArray, const GError *error);
+
+typedef void (*OnWriteStreamCompleteCallback)(Device *device, Characteristic *characteristic,
+                                              const GError *error);
+
 
 void binc_characteristic_read(Characteristic *characteristic);
 
 void binc_characteristic_write(Characteristic *characteristic, const GByteArray *byteArray, WriteType writeType);
 
+/**
+ * Write caller-owned memory without copying it.
+ *
+ * Unlike binc_characteristic_write() the bytes are not copied into a variant;
+ * the D-Bus message wraps 'data' directly and 'free_func' is called on it once
+ * the write no longer needs it. 'data' must stay valid and unmodified until
+ * then. Pass NULL as free_func for memory that outlives the write (e.g. a
+ * static buffer).
+ *
+ * @param characteristic the characteristic to write to
+ * @param data the bytes to write, ownership is transferred
+ * @param len number of bytes to write, must be > 0
+ * @param free_func called with 'data' when the write is done with it, or NULL
+ * @param writeType the write type to use
+ */
+void binc_characteristic_write_take(Characteristic *characteristic, guint8 *data, gsize len,
+                                    GDestroyNotify free_func, WriteType writeType);
+
+/**
+ * Queue a write-without-response and pipeline it.
+ *
+ * Buffers are coalesced up to the negotiated MTU, chunked when larger, and
+ * several write commands are kept in flight at once (see
+ * binc_characteristic_set_write_queue_depth). The OnWriteDrainedCallback
+ * fires when the queue is empty and nothing is in flight anymore, which is
+ * the moment to submit more data.
+ *
+ * @param characteristic the characteristic to write to
+ * @param byteArray the bytes to write, copied internally
+ * @return TRUE if the data was queued, FALSE if the characteristic does not support write-without-response
+ */
+gboolean binc_characteristic_write_queued(Characteristic *characteristic, const GByteArray *byteArray);
+
+void binc_characteristic_set_write_queue_depth(Characteristic *characteristic, guint depth);
+
+/**
+ * Read a value larger than the MTU in one go.
+ *
+ * Chunks are fetched with increasing offsets until a short chunk signals the
+ * end of the value; the reassembled value is delivered to the completion
+ * callback. Only one streaming read may run per characteristic at a time.
+ *
+ * @param characteristic the characteristic to read
+ * @param progress_callback called after every chunk, or NULL
+ * @param complete_callback called with the full value, or with an error
+ */
+void binc_characteristic_read_stream(Characteristic *characteristic,
+                                     OnStreamProgressCallback progress_callback,
+                                     OnReadStreamCompleteCallback complete_callback);
+
+/**
+ * Write a value larger than the MTU in one go.
+ *
+ * The value is chunked to the negotiated MTU and written with BlueZ's offset
+ * option; several chunks are kept in flight at once (see
+ * binc_characteristic_set_write_queue_depth) instead of waiting for each
+ * response before sending the next. Only one streaming write may run per
+ * characteristic at a time.
+ *
+ * @param characteristic the characteristic to write to
+ * @param byteArray the bytes to write, copied internally
+ * @param progress_callback called as chunks are acknowledged, or NULL
+ * @param complete_callback called when the whole value is written, or on the first error
+ */
+void binc_characteristic_write_stream(Characteristic *characteristic, const GByteArray *byteArray,
+                                      OnStreamProgressCallback progress_callback,
+                                      OnWriteStreamCompleteCallback complete_callback);
+
+void binc_characteristic_set_write_drained_cb(Characteristic *characteristic, OnWriteDrainedCallback callback);
+
 void binc_characteristic_start_notify(Characteristic *characteristic);
 
+/**
+ * Acquire a notification fd for this characteristic (BlueZ 'AcquireNotify').
+ *
+ * Notifications are then read straight from the socket and delivered to the
+ * OnNotifyCallback without going through D-Bus PropertiesChanged signals,
+ * which is significantly cheaper for high-rate characteristics.
+ * Requires the characteristic to have the 'notify' flag.
+ * Use binc_characteristic_stop_notify() to release the fd.
+ *
+ * @param characteristic the characteristic to acquire notifications for
+ */
+void binc_characteristic_acquire_notify(Characteristic *characteristic);
+
+/**
+ * Acquire a write fd for this characteristic (BlueZ 'AcquireWrite').
+ *
+ * Subsequent calls to binc_characteristic_write() with WITHOUT_RESPONSE will
+ * write directly to the socket instead of doing a WriteValue D-Bus call.
+ * Requires the characteristic to have the 'write-without-response' flag.
+ *
+ * @param characteristic the characteristic to acquire the write fd for
+ */
+void binc_characteristic_acquire_write(Characteristic *characteristic);
+
 void binc_characteristic_stop_notify(Characteristic *characteristic);
 
 Service *binc_characteristic_get_service(const Characteristic *characteristic);
@@ -100,6 +209,24 @@ gboolean binc_characteristic_supports_read(const Characteristic *characteristic)
 
 gboolean binc_characteristic_supports_notify(const Characteristic *characteristic);
 
+guint binc_characteristic_get_mtu(const Characteristic *characteristic);
+
+/**
+ * Get a borrowed view on the value currently being delivered.
+ *
+ * Only valid while an OnReadCallback or OnNotifyCallback for this
+ * characteristic is running; the pointer refers to the D-Bus message (or the
+ * acquired-fd read buffer) and is invalidated as soon as the callback
+ * returns, so parse in place or copy what you need. Returns NULL outside a
+ * value callback, or when callbacks are dispatched through a callback
+ * executor (which delivers copies).
+ *
+ * @param characteristic the characteristic
+ * @param length receives the number of bytes in the view
+ * @return borrowed pointer to the value bytes, or NULL
+ */
+const guint8 *binc_characteristic_get_value_view(const Characteristic *characteristic, gsize *length);
+
 Descriptor *binc_characteristic_get_descriptor(const Characteristic *characteristic, const char *desc_uuid);
 
 GList *binc_characteristic_get_descriptors(const Characteristic *characteristic);
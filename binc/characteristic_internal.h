@@ -59,6 +59,8 @@ const char *binc_characteristic_get_service_path(const Characteristic *character
 
 void binc_characteristic_add_descriptor(Characteristic *characteristic, Descriptor *descriptor);
 
+void binc_internal_characteristic_handle_properties_changed(Characteristic *characteristic, GVariant *parameters);
+
 #ifdef __cplusplus
 }
 #endif
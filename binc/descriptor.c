@@ -30,6 +30,7 @@
 #include "descriptor.h"
 #include "device_internal.h"
 #include "utility.h"
+#include "uuid.h"
 #include "logger.h"
 
 static const char *const TAG = "Descriptor";
@@ -45,7 +46,7 @@ struct binc_descriptor {
     GDBusConnection *connection; // Borrowed
     const char *path; // Owned
     const char *char_path; // Owned
-    const char *uuid; // Owned
+    const char *uuid; // Interned
     GList *flags; // Owned
 
     OnDescReadCallback on_read_cb;
@@ -72,7 +73,6 @@ void binc_descriptor_free(Descriptor *descriptor) {
         descriptor->flags = NULL;
     }
 
-    g_free((char *) descriptor->uuid);
     descriptor->uuid = NULL;
     g_free((char *) descriptor->path);
     descriptor->path = NULL;
@@ -112,8 +112,7 @@ void binc_descriptor_set_uuid(Descriptor *descriptor, const char *uuid) {
     g_assert(descriptor != NULL);
     g_assert(is_valid_uuid(uuid));
 
-    g_free((char *) descriptor->uuid);
-    descriptor->uuid = g_strdup(uuid);
+    descriptor->uuid = binc_uuid_intern_string(uuid);
 }
 
 void binc_descriptor_set_char_path(Descriptor *descriptor, const char *path) {
@@ -129,6 +128,11 @@ const char *binc_descriptor_get_char_path(const Descriptor *descriptor) {
     return descriptor->char_path;
 }
 
+GList *binc_descriptor_get_flags(const Descriptor *descriptor) {
+    g_assert(descriptor != NULL);
+    return descriptor->flags;
+}
+
 const char *binc_descriptor_get_uuid(const Descriptor *descriptor) {
     g_assert(descriptor != NULL);
     return descriptor->uuid;
@@ -257,9 +261,7 @@ void binc_descriptor_write(Descriptor *descriptor, const GByteArray *byteArray)
     g_assert(byteArray != NULL);
     g_assert(byteArray->len > 0);
 
-    GString *byteArrayStr = g_byte_array_as_hex(byteArray);
-    log_debug(TAG, "writing <%s> to <%s>", byteArrayStr->str, descriptor->uuid);
-    g_string_free(byteArrayStr, TRUE);
+    log_debug_hex(TAG, byteArray, "writing <%s> to <%s>", descriptor->uuid);
 
     GVariant *value = g_variant_new_fixed_array(G_VARIANT_TYPE_BYTE, byteArray->data, byteArray->len, sizeof(guint8));
 
@@ -44,4 +44,6 @@ void binc_descriptor_set_flags(Descriptor *descriptor, GList *flags);
 
 const char *binc_descriptor_get_char_path(const Descriptor *descriptor);
 
+GList *binc_descriptor_get_flags(const Descriptor *descriptor);
+
 #endif //BINC_DESCRIPTOR_INTERNAL_H
@@ -25,10 +25,15 @@
 #include "logger.h"
 #include "device.h"
 #include "utility.h"
+#include "uuid.h"
 #include "service_internal.h"
 #include "characteristic_internal.h"
 #include "adapter.h"
 #include "descriptor_internal.h"
+#include "executor.h"
+#include "object_manager.h"
+#include "stats.h"
+#include "gatt_cache.h"
 
 static const char *const TAG = "Device";
 static const char *const BLUEZ_DBUS = "org.bluez";
@@ -56,6 +61,9 @@ static const char *const INTERFACE_SERVICE = "org.bluez.GattService1";
 static const char *const INTERFACE_CHARACTERISTIC = "org.bluez.GattCharacteristic1";
 static const char *const INTERFACE_DESCRIPTOR = "org.bluez.GattDescriptor1";
 
+#define DEFAULT_NOTIFY_MAX_IN_FLIGHT 4
+#define DEFAULT_READ_MAX_IN_FLIGHT 4
+
 static const char *connection_state_names[] = {
         [BINC_DISCONNECTED] = "DISCONNECTED",
         [BINC_CONNECTED] = "CONNECTED",
@@ -63,6 +71,8 @@ static const char *connection_state_names[] = {
         [BINC_DISCONNECTING]  = "DISCONNECTING"
 };
 
+static void binc_internal_store_gatt_cache(Device *device);
+
 struct binc_device {
     GDBusConnection *connection; // Borrowed
     Adapter *adapter; // Borrowed
@@ -72,32 +82,56 @@ struct binc_device {
     ConnectionState connection_state;
     gboolean services_resolved;
     gboolean service_discovery_started;
+    gboolean gatt_tree_from_cache;
     gboolean paired;
     BondingState bondingState;
     const char *path; // Owned
     const char *name; // Owned
     short rssi;
+    float filtered_rssi;
+    gboolean rssi_filter_primed;
+    guint rssi_filter_window;
+    short range_enter_rssi;
+    short range_exit_rssi;
+    gboolean in_range;
+    RangeStateChangedCallback range_callback;
     gboolean trusted;
     short txpower;
-    GHashTable *manufacturer_data; // Owned
-    GHashTable *service_data; // Owned
-    GList *uuids; // Owned
+    GHashTable *manufacturer_data; // Owned, materialized lazily
+    GHashTable *service_data; // Owned, materialized lazily
+    GVariant *manufacturer_data_variant; // Owned
+    GVariant *service_data_variant; // Owned
+    GList *uuids; // Owned, elements are interned
     guint mtu;
 
-    guint device_prop_changed;
     ConnectionStateChangedCallback connection_state_callback;
     ServicesResolvedCallback services_resolved_callback;
     BondingStateChangedCallback bonding_state_callback;
+    BondingStateObserver bonding_observer; // Internal, used by the agent's bonding pipeline
+    gpointer bonding_observer_data; // Borrowed
     GHashTable *services; // Owned
     GList *services_list; // Owned
     GHashTable *characteristics; // Owned
+    GHashTable *characteristics_by_uuid; // Owned, "<service uuid>/<char uuid>" -> Characteristic (borrowed)
     GHashTable *descriptors; // Owned
     gboolean is_central;
+    gint64 last_seen; // Monotonic time of the last property update
 
     OnReadCallback on_read_callback;
     OnWriteCallback on_write_callback;
     OnNotifyCallback on_notify_callback;
     OnNotifyingStateChangedCallback on_notify_state_callback;
+    GQueue *notify_queue; // Owned, characteristics are borrowed
+    GPtrArray *notify_in_flight; // Owned, characteristics are borrowed
+    guint notify_max_in_flight;
+    guint notify_all_started;
+    guint notify_all_failed;
+    OnNotifyAllCompleteCallback notify_all_callback;
+    GQueue *read_queue; // Owned, characteristics are borrowed
+    GPtrArray *read_in_flight; // Owned, characteristics are borrowed
+    GPtrArray *read_results; // Owned
+    guint read_max_in_flight;
+    OnReadAllCompleteCallback read_all_callback;
     OnDescReadCallback on_read_desc_cb;
     OnDescWriteCallback on_write_desc_cb;
     void *user_data; // Borrowed
@@ -117,15 +151,17 @@ Device *binc_device_create(const char *path, Adapter *adapter) {
     device->bondingState = BINC_BOND_NONE;
     device->connection_state = BINC_DISCONNECTED;
     device->rssi = -255;
+    device->rssi_filter_window = 8;
     device->txpower = -255;
     device->mtu = 23;
     device->user_data = NULL;
+    device->last_seen = g_get_monotonic_time();
     return device;
 }
 
 static void binc_device_free_uuids(Device *device) {
     if (device->uuids != NULL) {
-        g_list_free_full(device->uuids, g_free);
+        g_list_free(device->uuids);
         device->uuids = NULL;
     }
 }
@@ -155,11 +191,14 @@ void binc_device_free(Device *device) {
 
     log_debug(TAG, "freeing %s", device->path);
 
-    if (device->device_prop_changed != 0) {
-        g_dbus_connection_signal_unsubscribe(device->connection, device->device_prop_changed);
-        device->device_prop_changed = 0;
+    // Queued executor tasks still reference this device; let them finish first
+    CallbackExecutor *executor = binc_internal_adapter_get_callback_executor(device->adapter);
+    if (executor != NULL) {
+        binc_callback_executor_drain(executor, device->path);
     }
 
+    binc_internal_store_gatt_cache(device);
+
     g_free((char *) device->path);
     device->path = NULL;
     g_free((char *) device->address_type);
@@ -176,6 +215,36 @@ void binc_device_free(Device *device) {
         device->descriptors = NULL;
     }
 
+    if (device->notify_queue != NULL) {
+        g_queue_free(device->notify_queue);
+        device->notify_queue = NULL;
+    }
+
+    if (device->notify_in_flight != NULL) {
+        g_ptr_array_free(device->notify_in_flight, TRUE);
+        device->notify_in_flight = NULL;
+    }
+
+    if (device->read_queue != NULL) {
+        g_queue_free(device->read_queue);
+        device->read_queue = NULL;
+    }
+
+    if (device->read_in_flight != NULL) {
+        g_ptr_array_free(device->read_in_flight, TRUE);
+        device->read_in_flight = NULL;
+    }
+
+    if (device->read_results != NULL) {
+        g_ptr_array_free(device->read_results, TRUE);
+        device->read_results = NULL;
+    }
+
+    if (device->characteristics_by_uuid != NULL) {
+        g_hash_table_destroy(device->characteristics_by_uuid);
+        device->characteristics_by_uuid = NULL;
+    }
+
     if (device->characteristics != NULL) {
         g_hash_table_destroy(device->characteristics);
         device->characteristics = NULL;
@@ -190,6 +259,16 @@ void binc_device_free(Device *device) {
     binc_device_free_service_data(device);
     binc_device_free_uuids(device);
 
+    if (device->manufacturer_data_variant != NULL) {
+        g_variant_unref(device->manufacturer_data_variant);
+        device->manufacturer_data_variant = NULL;
+    }
+
+    if (device->service_data_variant != NULL) {
+        g_variant_unref(device->service_data_variant);
+        device->service_data_variant = NULL;
+    }
+
     if (device->services_list != NULL) {
         g_list_free(device->services_list);
         device->services_list = NULL;
@@ -214,12 +293,13 @@ char *binc_device_to_string(const Device *device) {
     g_string_append(uuids, "]");
 
     // Build up manufacturer data string
+    GHashTable *manufacturer_data_table = binc_device_get_manufacturer_data(device);
     GString *manufacturer_data = g_string_new("[");
-    if (device->manufacturer_data != NULL && g_hash_table_size(device->manufacturer_data) > 0) {
+    if (manufacturer_data_table != NULL && g_hash_table_size(manufacturer_data_table) > 0) {
         GHashTableIter iter;
         int *key;
         gpointer value;
-        g_hash_table_iter_init(&iter, device->manufacturer_data);
+        g_hash_table_iter_init(&iter, manufacturer_data_table);
         while (g_hash_table_iter_next(&iter, (gpointer) &key, &value)) {
             GByteArray *byteArray = (GByteArray *) value;
             GString *byteArrayString = g_byte_array_as_hex(byteArray);
@@ -232,11 +312,12 @@ char *binc_device_to_string(const Device *device) {
     g_string_append(manufacturer_data, "]");
 
     // Build up service data string
+    GHashTable *service_data_table = binc_device_get_service_data(device);
     GString *service_data = g_string_new("[");
-    if (device->service_data != NULL && g_hash_table_size(device->service_data) > 0) {
+    if (service_data_table != NULL && g_hash_table_size(service_data_table) > 0) {
         GHashTableIter iter;
         gpointer key, value;
-        g_hash_table_iter_init(&iter, device->service_data);
+        g_hash_table_iter_init(&iter, service_data_table);
         while (g_hash_table_iter_next(&iter, &key, &value)) {
             GByteArray *byteArray = (GByteArray *) value;
             GString *byteArrayString = g_byte_array_as_hex(byteArray);
@@ -267,30 +348,144 @@ char *binc_device_to_string(const Device *device) {
     return result;
 }
 
+typedef enum CharacteristicTaskType {
+    CHARACTERISTIC_TASK_READ, CHARACTERISTIC_TASK_WRITE, CHARACTERISTIC_TASK_NOTIFY
+} CharacteristicTaskType;
+
+typedef struct binc_characteristic_task {
+    CharacteristicTaskType type;
+    Device *device; // Borrowed
+    Characteristic *characteristic; // Borrowed
+    GByteArray *byteArray; // Owned
+    GError *error; // Owned
+} CharacteristicTask;
+
+static void binc_internal_characteristic_task(gpointer task_data) {
+    CharacteristicTask *task = (CharacteristicTask *) task_data;
+    Device *device = task->device;
+
+    switch (task->type) {
+        case CHARACTERISTIC_TASK_READ:
+            device->on_read_callback(device, task->characteristic, task->byteArray, task->error);
+            break;
+        case CHARACTERISTIC_TASK_WRITE:
+            device->on_write_callback(device, task->characteristic, task->byteArray, task->error);
+            break;
+        case CHARACTERISTIC_TASK_NOTIFY:
+            device->on_notify_callback(device, task->characteristic, task->byteArray);
+            break;
+    }
+
+    if (task->byteArray != NULL) {
+        g_byte_array_free(task->byteArray, TRUE);
+    }
+    if (task->error != NULL) {
+        g_error_free(task->error);
+    }
+    g_free(task);
+}
+
+/*
+ * Hand a characteristic callback to the adapter's callback executor, keyed by
+ * device path so callbacks for one device keep their order. The byte array and
+ * error are copied because the originals don't outlive the dispatching call.
+ */
+static void binc_internal_submit_characteristic_task(Device *device, CharacteristicTaskType type,
+                                                     Characteristic *characteristic, const GByteArray *byteArray,
+                                                     const GError *error) {
+    CharacteristicTask *task = g_new0(CharacteristicTask, 1);
+    task->type = type;
+    task->device = device;
+    task->characteristic = characteristic;
+    if (byteArray != NULL) {
+        task->byteArray = g_byte_array_sized_new(byteArray->len);
+        g_byte_array_append(task->byteArray, byteArray->data, byteArray->len);
+    }
+    if (error != NULL) {
+        task->error = g_error_copy(error);
+    }
+    binc_callback_executor_submit(binc_internal_adapter_get_callback_executor(device->adapter),
+                                  device->path, binc_internal_characteristic_task, task);
+}
+
+static void binc_internal_pump_read_queue(Device *device);
+
 static void
 binc_on_characteristic_read(Device *device, Characteristic *characteristic, const GByteArray *byteArray, const GError *error) {
     if (device->on_read_callback != NULL) {
-        device->on_read_callback(device, characteristic, byteArray, error);
+        if (binc_internal_adapter_get_callback_executor(device->adapter) != NULL) {
+            binc_internal_submit_characteristic_task(device, CHARACTERISTIC_TASK_READ, characteristic, byteArray, error);
+        } else {
+            device->on_read_callback(device, characteristic, byteArray, error);
+        }
+    }
+
+    // Collect the result for a bulk read that is waiting for this characteristic
+    if (device->read_in_flight != NULL) {
+        guint index;
+        if (g_ptr_array_find(device->read_in_flight, characteristic, &index)) {
+            g_ptr_array_remove_index_fast(device->read_in_flight, index);
+
+            CharacteristicReadResult *result = g_new0(CharacteristicReadResult, 1);
+            result->characteristic = characteristic;
+            if (error != NULL) {
+                result->error = g_error_copy(error);
+            } else if (byteArray != NULL) {
+                result->value = g_byte_array_sized_new(byteArray->len);
+                g_byte_array_append(result->value, byteArray->data, byteArray->len);
+            }
+            g_ptr_array_add(device->read_results, result);
+            binc_internal_pump_read_queue(device);
+        }
     }
 }
 
 static void
 binc_on_characteristic_write(Device *device, Characteristic *characteristic, const GByteArray *byteArray, const GError *error) {
     if (device->on_write_callback != NULL) {
-        device->on_write_callback(device, characteristic, byteArray, error);
+        if (binc_internal_adapter_get_callback_executor(device->adapter) != NULL) {
+            binc_internal_submit_characteristic_task(device, CHARACTERISTIC_TASK_WRITE, characteristic, byteArray, error);
+        } else {
+            device->on_write_callback(device, characteristic, byteArray, error);
+        }
     }
 }
 
 static void binc_on_characteristic_notify(Device *device, Characteristic *characteristic, const GByteArray *byteArray) {
     if (device->on_notify_callback != NULL) {
-        device->on_notify_callback(device, characteristic, byteArray);
+        binc_internal_stats_add(BINC_STATS_NOTIFICATIONS_RECEIVED, 1);
+        if (binc_internal_adapter_get_callback_executor(device->adapter) != NULL) {
+            binc_internal_submit_characteristic_task(device, CHARACTERISTIC_TASK_NOTIFY, characteristic, byteArray, NULL);
+        } else if (binc_stats_is_enabled()) {
+            gint64 started = g_get_monotonic_time();
+            device->on_notify_callback(device, characteristic, byteArray);
+            binc_internal_stats_record_notify_latency((g_get_monotonic_time() - started) / 1000);
+        } else {
+            device->on_notify_callback(device, characteristic, byteArray);
+        }
     }
 }
 
+static void binc_internal_pump_notify_queue(Device *device);
+
 static void binc_on_characteristic_notification_state_changed(Device *device, Characteristic *characteristic, const GError *error) {
     if (device->on_notify_state_callback != NULL) {
         device->on_notify_state_callback(device, characteristic, error);
     }
+
+    // Settle a batch subscription that is waiting for this characteristic
+    if (device->notify_in_flight != NULL) {
+        guint index;
+        if (g_ptr_array_find(device->notify_in_flight, characteristic, &index)) {
+            g_ptr_array_remove_index_fast(device->notify_in_flight, index);
+            if (error == NULL && binc_characteristic_is_notifying(characteristic)) {
+                device->notify_all_started++;
+            } else {
+                device->notify_all_failed++;
+            }
+            binc_internal_pump_notify_queue(device);
+        }
+    }
 }
 
 static void binc_on_descriptor_read(Device *device, Descriptor *descriptor, const GByteArray *byteArray, const GError *error) {
@@ -431,78 +626,177 @@ static void binc_internal_extract_descriptor(Device *device, const char *object_
     }
 }
 
-static void binc_internal_collect_gatt_tree_cb(__attribute__((unused)) GObject *source_object,
-                                               GAsyncResult *res,
-                                               gpointer user_data) {
+static void binc_internal_extract_service_func(const char *object_path, const char *interface_name,
+                                               GVariant *properties, gpointer user_data) {
+    if (g_str_equal(interface_name, INTERFACE_SERVICE)) {
+        binc_internal_extract_service((Device *) user_data, object_path, properties);
+    }
+}
 
-    GError *error = NULL;
-    Device *device = (Device *) user_data;
+static void binc_internal_extract_characteristic_func(const char *object_path, const char *interface_name,
+                                                      GVariant *properties, gpointer user_data) {
+    if (g_str_equal(interface_name, INTERFACE_CHARACTERISTIC)) {
+        binc_internal_extract_characteristic((Device *) user_data, object_path, properties);
+    }
+}
+
+static void binc_internal_extract_descriptor_func(const char *object_path, const char *interface_name,
+                                                  GVariant *properties, gpointer user_data) {
+    if (g_str_equal(interface_name, INTERFACE_DESCRIPTOR)) {
+        binc_internal_extract_descriptor((Device *) user_data, object_path, properties);
+    }
+}
+
+static char *binc_internal_characteristic_index_key(const char *service_uuid, const char *characteristic_uuid) {
+    return g_strdup_printf("%s/%s", service_uuid, characteristic_uuid);
+}
+
+// Index every characteristic on (service uuid, characteristic uuid) so the
+// read/write/notify entry points resolve their target in O(1)
+static void binc_internal_build_characteristic_index(Device *device) {
     g_assert(device != NULL);
 
-    GVariant *result = g_dbus_connection_call_finish(device->connection, res, &error);
+    if (device->characteristics_by_uuid != NULL) {
+        g_hash_table_destroy(device->characteristics_by_uuid);
+    }
+    device->characteristics_by_uuid = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
+
+    GHashTableIter iter;
+    gpointer key, value;
+    g_hash_table_iter_init(&iter, device->characteristics);
+    while (g_hash_table_iter_next(&iter, &key, &value)) {
+        Characteristic *characteristic = (Characteristic *) value;
+        Service *service = binc_characteristic_get_service(characteristic);
+        char *index_key = binc_internal_characteristic_index_key(binc_service_get_uuid(service),
+                                                                binc_characteristic_get_uuid(characteristic));
+        g_hash_table_insert(device->characteristics_by_uuid, index_key, characteristic);
+    }
+}
 
-    if (result == NULL) {
-        log_error(TAG, "Unable to get result for GetManagedObjects");
-        if (error != NULL) {
-            log_error(TAG, "call failed (error %d: %s)", error->code, error->message);
-            g_clear_error(&error);
-            return;
-        }
+static void binc_internal_reset_gatt_tables(Device *device) {
+    g_assert(device != NULL);
+
+    if (device->services != NULL) {
+        g_hash_table_destroy(device->services);
     }
+    device->services = g_hash_table_new_full(g_str_hash, g_str_equal,
+                                             g_free, (GDestroyNotify) binc_service_free);
 
-    GVariantIter *iter;
-    const char *object_path;
-    GVariant *ifaces_and_properties;
-    if (result) {
-        if (device->services != NULL) {
-            g_hash_table_destroy(device->services);
-        }
-        device->services = g_hash_table_new_full(g_str_hash, g_str_equal,
-                                                 g_free, (GDestroyNotify) binc_service_free);
+    if (device->characteristics != NULL) {
+        g_hash_table_destroy(device->characteristics);
+    }
+    device->characteristics = g_hash_table_new_full(g_str_hash, g_str_equal,
+                                                    g_free, (GDestroyNotify) binc_characteristic_free);
 
-        if (device->characteristics != NULL) {
-            g_hash_table_destroy(device->characteristics);
-        }
-        device->characteristics = g_hash_table_new_full(g_str_hash, g_str_equal,
-                                                        g_free, (GDestroyNotify) binc_characteristic_free);
+    if (device->descriptors != NULL) {
+        g_hash_table_destroy(device->descriptors);
+    }
+    device->descriptors = g_hash_table_new_full(g_str_hash, g_str_equal,
+                                                g_free, (GDestroyNotify) binc_descriptor_free);
+}
 
-        if (device->descriptors != NULL) {
-            g_hash_table_destroy(device->descriptors);
-        }
-        device->descriptors = g_hash_table_new_full(g_str_hash, g_str_equal,
-                                                    g_free, (GDestroyNotify) binc_descriptor_free);
-
-        g_assert(g_str_equal(g_variant_get_type_string(result), "(a{oa{sa{sv}}})"));
-        g_variant_get(result, "(a{oa{sa{sv}}})", &iter);
-        while (g_variant_iter_loop(iter, "{&o@a{sa{sv}}}", &object_path, &ifaces_and_properties)) {
-            if (g_str_has_prefix(object_path, device->path)) {
-                const char *interface_name;
-                GVariant *properties;
-                GVariantIter iter2;
-                g_variant_iter_init(&iter2, ifaces_and_properties);
-                while (g_variant_iter_loop(&iter2, "{&s@a{sv}}", &interface_name, &properties)) {
-                    if (g_str_equal(interface_name, INTERFACE_SERVICE)) {
-                        binc_internal_extract_service(device, object_path, properties);
-                    } else if (g_str_equal(interface_name, INTERFACE_CHARACTERISTIC)) {
-                        binc_internal_extract_characteristic(device, object_path, properties);
-                    } else if (g_str_equal(interface_name, INTERFACE_DESCRIPTOR)) {
-                        binc_internal_extract_descriptor(device, object_path, properties);
-
-                    }
-                }
-            }
-        }
+static void binc_internal_store_gatt_cache(Device *device) {
+    g_assert(device != NULL);
+
+    if (!binc_gatt_cache_is_enabled() || device->address == NULL) return;
+    if (device->services == NULL || device->characteristics == NULL) return;
 
-        if (iter != NULL) {
-            g_variant_iter_free(iter);
+    GattCacheBuilder *builder = binc_gatt_cache_builder_create();
+
+    GHashTableIter iter;
+    gpointer key, value;
+    g_hash_table_iter_init(&iter, device->services);
+    while (g_hash_table_iter_next(&iter, &key, &value)) {
+        binc_gatt_cache_builder_add_service(builder, (const char *) key,
+                                            binc_service_get_uuid((Service *) value));
+    }
+
+    g_hash_table_iter_init(&iter, device->characteristics);
+    while (g_hash_table_iter_next(&iter, &key, &value)) {
+        Characteristic *characteristic = (Characteristic *) value;
+        binc_gatt_cache_builder_add_characteristic(builder, (const char *) key,
+                                                   binc_characteristic_get_service_path(characteristic),
+                                                   binc_characteristic_get_uuid(characteristic),
+                                                   binc_characteristic_get_flags(characteristic));
+    }
+
+    if (device->descriptors != NULL) {
+        g_hash_table_iter_init(&iter, device->descriptors);
+        while (g_hash_table_iter_next(&iter, &key, &value)) {
+            Descriptor *descriptor = (Descriptor *) value;
+            binc_gatt_cache_builder_add_descriptor(builder, (const char *) key,
+                                                   binc_descriptor_get_char_path(descriptor),
+                                                   binc_descriptor_get_uuid(descriptor),
+                                                   binc_descriptor_get_flags(descriptor));
         }
-        g_variant_unref(result);
     }
 
+    binc_gatt_cache_builder_store(builder, device->address);
+    binc_gatt_cache_builder_free(builder);
+}
+
+static void binc_internal_extract_cached_gatt_object_func(const char *object_path, const char *interface_name,
+                                                          GVariant *properties, gpointer user_data) {
+    binc_internal_extract_service_func(object_path, interface_name, properties, user_data);
+    binc_internal_extract_characteristic_func(object_path, interface_name, properties, user_data);
+    binc_internal_extract_descriptor_func(object_path, interface_name, properties, user_data);
+}
+
+/*
+ * Rebuild the GATT tree from the on-disk cache so the services resolved
+ * callback can fire without waiting for BlueZ's service resolution. When
+ * ServicesResolved arrives later, the cache-built tree is reconciled against
+ * the live database; the cache is refreshed on every real resolution.
+ */
+static gboolean binc_internal_restore_gatt_tree_from_disk(Device *device) {
+    g_assert(device != NULL);
+
+    if (!binc_gatt_cache_is_enabled() || device->address == NULL) return FALSE;
+    if (!binc_gatt_cache_exists(device->address)) return FALSE;
+
+    binc_internal_reset_gatt_tables(device);
+    if (!binc_gatt_cache_load(device->address, binc_internal_extract_cached_gatt_object_func, device) ||
+        g_hash_table_size(device->services) == 0) {
+        binc_gatt_cache_remove(device->address);
+        return FALSE;
+    }
+
+    binc_internal_build_characteristic_index(device);
+
     if (device->services_list != NULL) {
         g_list_free(device->services_list);
     }
     device->services_list = g_hash_table_get_values(device->services);
+    device->gatt_tree_from_cache = TRUE;
+    device->service_discovery_started = TRUE;
+
+    log_debug(TAG, "restored %d services from cache", g_list_length(device->services_list));
+    if (device->services_resolved_callback != NULL) {
+        device->services_resolved_callback(device);
+    }
+    return TRUE;
+}
+
+static void binc_internal_collect_gatt_tree_from_cache(ObjectManagerCache *cache, gpointer user_data) {
+    Device *device = (Device *) user_data;
+    g_assert(device != NULL);
+
+    binc_internal_reset_gatt_tables(device);
+
+    // Three passes so that services exist before their characteristics are
+    // linked, and characteristics before their descriptors
+    binc_object_manager_cache_foreach(cache, device->path, binc_internal_extract_service_func, device);
+    binc_object_manager_cache_foreach(cache, device->path, binc_internal_extract_characteristic_func, device);
+    binc_object_manager_cache_foreach(cache, device->path, binc_internal_extract_descriptor_func, device);
+
+    binc_internal_build_characteristic_index(device);
+
+    if (device->services_list != NULL) {
+        g_list_free(device->services_list);
+    }
+    device->services_list = g_hash_table_get_values(device->services);
+    device->gatt_tree_from_cache = FALSE;
+    binc_internal_store_gatt_cache(device);
 
     log_debug(TAG, "found %d services", g_list_length(device->services_list));
     if (device->services_resolved_callback != NULL) {
@@ -510,22 +804,73 @@ static void binc_internal_collect_gatt_tree_cb(__attribute__((unused)) GObject *
     }
 }
 
+typedef struct {
+    Device *device; // Borrowed
+    guint matched;
+    gboolean mismatch;
+} GattReconcileState;
+
+static void binc_internal_reconcile_gatt_object_func(const char *object_path, const char *interface_name,
+                                                     __attribute__((unused)) GVariant *properties,
+                                                     gpointer user_data) {
+    GattReconcileState *state = (GattReconcileState *) user_data;
+
+    GHashTable *table = NULL;
+    if (g_str_equal(interface_name, INTERFACE_SERVICE)) {
+        table = state->device->services;
+    } else if (g_str_equal(interface_name, INTERFACE_CHARACTERISTIC)) {
+        table = state->device->characteristics;
+    } else if (g_str_equal(interface_name, INTERFACE_DESCRIPTOR)) {
+        table = state->device->descriptors;
+    } else {
+        return;
+    }
+
+    if (g_hash_table_contains(table, object_path)) {
+        state->matched++;
+    } else {
+        state->mismatch = TRUE;
+    }
+}
+
+/*
+ * Validate a cache-built GATT tree once ServicesResolved arrives. BlueZ
+ * object paths encode the attribute handles, so the cached tree is current
+ * exactly when its object paths match the live subtree. On a match the tree
+ * the application already received stays valid; on a mismatch the stale cache
+ * file is dropped and the tree is rebuilt from the live database, firing the
+ * services resolved callback again so stale pointers get replaced.
+ */
+static void binc_internal_reconcile_gatt_tree_from_cache(ObjectManagerCache *cache, gpointer user_data) {
+    Device *device = (Device *) user_data;
+    g_assert(device != NULL);
+
+    GattReconcileState state = {device, 0, FALSE};
+    binc_object_manager_cache_foreach(cache, device->path, binc_internal_reconcile_gatt_object_func, &state);
+
+    guint cached = g_hash_table_size(device->services) + g_hash_table_size(device->characteristics) +
+                   g_hash_table_size(device->descriptors);
+    if (!state.mismatch && state.matched == cached) {
+        log_debug(TAG, "cached gatt tree matches resolved services");
+        device->gatt_tree_from_cache = FALSE;
+        return;
+    }
+
+    log_debug(TAG, "cached gatt tree is stale, rebuilding");
+    binc_gatt_cache_remove(device->address);
+    binc_internal_collect_gatt_tree_from_cache(cache, device);
+}
+
 static void binc_collect_gatt_tree(Device *device) {
     g_assert(device != NULL);
 
     device->service_discovery_started = TRUE;
-    g_dbus_connection_call(device->connection,
-                           BLUEZ_DBUS,
-                           "/",
-                           "org.freedesktop.DBus.ObjectManager",
-                           "GetManagedObjects",
-                           NULL,
-                           G_VARIANT_TYPE("(a{oa{sa{sv}}})"),
-                           G_DBUS_CALL_FLAGS_NONE,
-                           -1,
-                           NULL,
-                           (GAsyncReadyCallback) binc_internal_collect_gatt_tree_cb,
-                           device);
+
+    // The cache receives the InterfacesAdded signals for the GATT objects
+    // before ServicesResolved turns true, so by the time we get here the
+    // device's subtree is present and resolution is a local lookup
+    ObjectManagerCache *cache = binc_adapter_get_object_manager_cache(device->adapter);
+    binc_object_manager_cache_when_ready(cache, binc_internal_collect_gatt_tree_from_cache, device);
 }
 
 void binc_device_set_bonding_state_changed_cb(Device *device, BondingStateChangedCallback callback) {
@@ -540,20 +885,25 @@ void binc_device_set_bonding_state(Device *device, BondingState bonding_state) {
 
     BondingState old_state = device->bondingState;
     device->bondingState = bonding_state;
-    if (device->bonding_state_callback != NULL) {
-        if (device->bondingState != old_state) {
+    if (device->bondingState != old_state) {
+        if (device->bonding_state_callback != NULL) {
             device->bonding_state_callback(device, device->bondingState, old_state, NULL);
         }
+        if (device->bonding_observer != NULL) {
+            device->bonding_observer(device, device->bonding_observer_data);
+        }
     }
 }
 
-static void binc_device_changed(__attribute__((unused)) GDBusConnection *conn,
-                                __attribute__((unused)) const gchar *sender,
-                                __attribute__((unused)) const gchar *path,
-                                __attribute__((unused)) const gchar *interface,
-                                __attribute__((unused)) const gchar *signal,
-                                GVariant *params,
-                                void *userdata) {
+void binc_internal_device_set_bonding_observer(Device *device, BondingStateObserver observer, gpointer user_data) {
+    g_assert(device != NULL);
+    device->bonding_observer = observer;
+    device->bonding_observer_data = user_data;
+}
+
+void binc_internal_device_handle_properties_changed(Device *device, GVariant *params) {
+    g_assert(device != NULL);
+    g_assert(params != NULL);
 
     GVariantIter *properties_changed = NULL;
     GVariantIter *properties_invalidated = NULL;
@@ -561,23 +911,26 @@ static void binc_device_changed(__attribute__((unused)) GDBusConnection *conn,
     const char *property_name = NULL;
     GVariant *property_value = NULL;
 
-    Device *device = (Device *) userdata;
-    g_assert(device != NULL);
-
     g_assert(g_str_equal(g_variant_get_type_string(params), "(sa{sv}as)"));
     g_variant_get(params, "(&sa{sv}as)", &iface, &properties_changed, &properties_invalidated);
     while (g_variant_iter_loop(properties_changed, "{&sv}", &property_name, &property_value)) {
         if (g_str_equal(property_name, DEVICE_PROPERTY_CONNECTED)) {
             binc_device_internal_set_conn_state(device, g_variant_get_boolean(property_value), NULL);
-            if (device->connection_state == BINC_DISCONNECTED) {
-                g_dbus_connection_signal_unsubscribe(device->connection, device->device_prop_changed);
-                device->device_prop_changed = 0;
+            if (device->connection_state == BINC_CONNECTED && device->services == NULL &&
+                !device->service_discovery_started) {
+                binc_internal_restore_gatt_tree_from_disk(device);
             }
         } else if (g_str_equal(property_name, DEVICE_PROPERTY_SERVICES_RESOLVED)) {
             device->services_resolved = g_variant_get_boolean(property_value);
             log_debug(TAG, "ServicesResolved %s", device->services_resolved ? "true" : "false");
             if (device->services_resolved == TRUE && device->bondingState != BINC_BONDING) {
-                binc_collect_gatt_tree(device);
+                if (device->gatt_tree_from_cache) {
+                    ObjectManagerCache *cache = binc_adapter_get_object_manager_cache(device->adapter);
+                    binc_object_manager_cache_when_ready(cache, binc_internal_reconcile_gatt_tree_from_cache,
+                                                         device);
+                } else {
+                    binc_collect_gatt_tree(device);
+                }
             }
 
             if (device->services_resolved == FALSE && device->connection_state == BINC_CONNECTED) {
@@ -626,21 +979,6 @@ static void binc_internal_device_connect_cb(__attribute__((unused)) GObject *sou
     }
 }
 
-static void subscribe_prop_changed(Device *device) {
-    if (device->device_prop_changed == 0) {
-        device->device_prop_changed = g_dbus_connection_signal_subscribe(device->connection,
-                                                                         BLUEZ_DBUS,
-                                                                         "org.freedesktop.DBus.Properties",
-                                                                         "PropertiesChanged",
-                                                                         device->path,
-                                                                         INTERFACE_DEVICE,
-                                                                         G_DBUS_SIGNAL_FLAGS_NONE,
-                                                                         binc_device_changed,
-                                                                         device,
-                                                                         NULL);
-    }
-}
-
 void binc_device_connect(Device *device) {
     g_assert(device != NULL);
     g_assert(device->path != NULL);
@@ -652,7 +990,6 @@ void binc_device_connect(Device *device) {
               device->paired ? "BINC_BONDED" : "BINC_BOND_NONE");
 
     binc_device_internal_set_conn_state(device, BINC_CONNECTING, NULL);
-    subscribe_prop_changed(device);
     g_dbus_connection_call(device->connection,
                            BLUEZ_DBUS,
                            device->path,
@@ -701,7 +1038,6 @@ void binc_device_pair(Device *device) {
         binc_device_internal_set_conn_state(device, BINC_CONNECTING, NULL);
     }
 
-    subscribe_prop_changed(device);
     g_dbus_connection_call(device->connection,
                            BLUEZ_DBUS,
                            device->path,
@@ -745,6 +1081,7 @@ void binc_device_disconnect(Device *device) {
 
     log_debug(TAG, "Disconnecting '%s' (%s)", device->name, device->address);
 
+    binc_internal_store_gatt_cache(device);
     binc_device_internal_set_conn_state(device, BINC_DISCONNECTING, NULL);
     g_dbus_connection_call(device->connection,
                            BLUEZ_DBUS,
@@ -786,9 +1123,10 @@ Service *binc_device_get_service(const Device *device, const char *service_uuid)
     g_assert(g_uuid_string_is_valid(service_uuid));
 
     if (device->services_list != NULL) {
+        const char *interned_uuid = binc_uuid_intern_string(service_uuid);
         for (GList *iterator = device->services_list; iterator; iterator = iterator->next) {
             Service *service = (Service *) iterator->data;
-            if (g_str_equal(service_uuid, binc_service_get_uuid(service))) {
+            if (interned_uuid == binc_service_get_uuid(service)) {
                 return service;
             }
         }
@@ -805,9 +1143,11 @@ binc_device_get_characteristic(const Device *device, const char *service_uuid, c
     g_assert(g_uuid_string_is_valid(service_uuid));
     g_assert(g_uuid_string_is_valid(characteristic_uuid));
 
-    Service *service = binc_device_get_service(device, service_uuid);
-    if (service != NULL) {
-        return binc_service_get_characteristic(service, characteristic_uuid);
+    if (device->characteristics_by_uuid != NULL) {
+        // UUID strings are at most 36 characters so the key fits on the stack
+        char index_key[80];
+        g_snprintf(index_key, sizeof(index_key), "%s/%s", service_uuid, characteristic_uuid);
+        return g_hash_table_lookup(device->characteristics_by_uuid, index_key);
     }
 
     return NULL;
@@ -831,6 +1171,86 @@ gboolean binc_device_read_char(const Device *device, const char *service_uuid, c
     return FALSE;
 }
 
+static void binc_internal_read_result_free(CharacteristicReadResult *result) {
+    g_assert(result != NULL);
+
+    if (result->value != NULL) {
+        g_byte_array_free(result->value, TRUE);
+        result->value = NULL;
+    }
+    if (result->error != NULL) {
+        g_error_free(result->error);
+        result->error = NULL;
+    }
+    g_free(result);
+}
+
+static void binc_internal_pump_read_queue(Device *device) {
+    g_assert(device != NULL);
+
+    while (device->read_in_flight->len < device->read_max_in_flight &&
+           !g_queue_is_empty(device->read_queue)) {
+        Characteristic *characteristic = g_queue_pop_head(device->read_queue);
+        g_ptr_array_add(device->read_in_flight, characteristic);
+        binc_characteristic_read(characteristic);
+    }
+
+    if (g_queue_is_empty(device->read_queue) && device->read_in_flight->len == 0 &&
+        device->read_all_callback != NULL) {
+        OnReadAllCompleteCallback callback = device->read_all_callback;
+        GPtrArray *results = device->read_results;
+        device->read_all_callback = NULL;
+        device->read_results = NULL;
+        callback(device, results);
+        g_ptr_array_free(results, TRUE);
+    }
+}
+
+void binc_device_read_chars(Device *device, const GPtrArray *characteristic_uuids, guint max_in_flight,
+                            OnReadAllCompleteCallback callback) {
+    g_assert(device != NULL);
+    g_assert(characteristic_uuids != NULL);
+    g_assert(callback != NULL);
+
+    if (device->read_queue == NULL) {
+        device->read_queue = g_queue_new();
+        device->read_in_flight = g_ptr_array_new();
+    }
+
+    // Only one bulk read at a time
+    g_assert(g_queue_is_empty(device->read_queue) && device->read_in_flight->len == 0);
+    g_assert(device->read_results == NULL);
+
+    device->read_max_in_flight = max_in_flight > 0 ? max_in_flight : DEFAULT_READ_MAX_IN_FLIGHT;
+    device->read_all_callback = callback;
+    device->read_results = g_ptr_array_new_with_free_func((GDestroyNotify) binc_internal_read_result_free);
+
+    for (guint i = 0; i < characteristic_uuids->len; i++) {
+        const char *uuid = g_ptr_array_index(characteristic_uuids, i);
+        gboolean found = FALSE;
+
+        if (device->characteristics != NULL) {
+            GHashTableIter iter;
+            gpointer value;
+            g_hash_table_iter_init(&iter, device->characteristics);
+            while (g_hash_table_iter_next(&iter, NULL, &value)) {
+                Characteristic *characteristic = (Characteristic *) value;
+                if (g_str_equal(binc_characteristic_get_uuid(characteristic), uuid) &&
+                    binc_characteristic_supports_read(characteristic)) {
+                    g_queue_push_tail(device->read_queue, characteristic);
+                    found = TRUE;
+                }
+            }
+        }
+
+        if (!found) {
+            log_debug(TAG, "no readable characteristic with uuid %s", uuid);
+        }
+    }
+
+    binc_internal_pump_read_queue(device);
+}
+
 gboolean binc_device_read_desc(const Device *device, const char *service_uuid,
                                const char *characteristic_uuid, const char *desc_uuid) {
     g_assert(is_valid_uuid(service_uuid));
@@ -916,6 +1336,74 @@ gboolean binc_device_start_notify(const Device *device, const char *service_uuid
     return FALSE;
 }
 
+static void binc_internal_pump_notify_queue(Device *device) {
+    g_assert(device != NULL);
+
+    while (device->notify_in_flight->len < device->notify_max_in_flight &&
+           !g_queue_is_empty(device->notify_queue)) {
+        Characteristic *characteristic = g_queue_pop_head(device->notify_queue);
+        if (binc_characteristic_is_notifying(characteristic)) {
+            // Already live, nothing to do
+            device->notify_all_started++;
+            continue;
+        }
+        g_ptr_array_add(device->notify_in_flight, characteristic);
+        binc_characteristic_start_notify(characteristic);
+    }
+
+    if (g_queue_is_empty(device->notify_queue) && device->notify_in_flight->len == 0 &&
+        device->notify_all_callback != NULL) {
+        OnNotifyAllCompleteCallback callback = device->notify_all_callback;
+        device->notify_all_callback = NULL;
+        callback(device, device->notify_all_started, device->notify_all_failed);
+    }
+}
+
+void binc_device_start_notify_all(Device *device, const GPtrArray *characteristic_uuids, guint max_in_flight,
+                                  OnNotifyAllCompleteCallback callback) {
+    g_assert(device != NULL);
+    g_assert(characteristic_uuids != NULL);
+
+    if (device->notify_queue == NULL) {
+        device->notify_queue = g_queue_new();
+        device->notify_in_flight = g_ptr_array_new();
+    }
+
+    // Only one batch subscription at a time
+    g_assert(g_queue_is_empty(device->notify_queue) && device->notify_in_flight->len == 0);
+
+    device->notify_max_in_flight = max_in_flight > 0 ? max_in_flight : DEFAULT_NOTIFY_MAX_IN_FLIGHT;
+    device->notify_all_callback = callback;
+    device->notify_all_started = 0;
+    device->notify_all_failed = 0;
+
+    for (guint i = 0; i < characteristic_uuids->len; i++) {
+        const char *uuid = g_ptr_array_index(characteristic_uuids, i);
+        gboolean found = FALSE;
+
+        if (device->characteristics != NULL) {
+            GHashTableIter iter;
+            gpointer value;
+            g_hash_table_iter_init(&iter, device->characteristics);
+            while (g_hash_table_iter_next(&iter, NULL, &value)) {
+                Characteristic *characteristic = (Characteristic *) value;
+                if (g_str_equal(binc_characteristic_get_uuid(characteristic), uuid) &&
+                    binc_characteristic_supports_notify(characteristic)) {
+                    g_queue_push_tail(device->notify_queue, characteristic);
+                    found = TRUE;
+                }
+            }
+        }
+
+        if (!found) {
+            log_debug(TAG, "no notifiable characteristic with uuid %s", uuid);
+            device->notify_all_failed++;
+        }
+    }
+
+    binc_internal_pump_notify_queue(device);
+}
+
 gboolean binc_device_stop_notify(const Device *device, const char *service_uuid, const char *characteristic_uuid) {
     g_assert(device != NULL);
     g_assert(is_valid_uuid(service_uuid));
@@ -1037,6 +1525,47 @@ short binc_device_get_rssi(const Device *device) {
 void binc_device_set_rssi(Device *device, short rssi) {
     g_assert(device != NULL);
     device->rssi = rssi;
+
+    // Incremental EWMA: the library sees every sample anyway, so filtering
+    // here is a handful of float operations per update
+    if (!device->rssi_filter_primed) {
+        device->filtered_rssi = (float) rssi;
+        device->rssi_filter_primed = TRUE;
+    } else {
+        float alpha = 2.0f / ((float) device->rssi_filter_window + 1.0f);
+        device->filtered_rssi += alpha * ((float) rssi - device->filtered_rssi);
+    }
+
+    if (device->range_callback != NULL) {
+        if (!device->in_range && device->filtered_rssi >= (float) device->range_enter_rssi) {
+            device->in_range = TRUE;
+            device->range_callback(device, TRUE);
+        } else if (device->in_range && device->filtered_rssi < (float) device->range_exit_rssi) {
+            device->in_range = FALSE;
+            device->range_callback(device, FALSE);
+        }
+    }
+}
+
+short binc_device_get_filtered_rssi(const Device *device) {
+    g_assert(device != NULL);
+    return device->rssi_filter_primed ? (short) device->filtered_rssi : device->rssi;
+}
+
+void binc_device_set_rssi_filter_window(Device *device, guint window) {
+    g_assert(device != NULL);
+    g_assert(window > 0);
+    device->rssi_filter_window = window;
+}
+
+void binc_device_set_range_cb(Device *device, short enter_rssi, short exit_rssi,
+                              RangeStateChangedCallback callback) {
+    g_assert(device != NULL);
+    g_assert(exit_rssi <= enter_rssi);
+
+    device->range_enter_rssi = enter_rssi;
+    device->range_exit_rssi = exit_rssi;
+    device->range_callback = callback;
 }
 
 gboolean binc_device_get_trusted(const Device *device) {
@@ -1068,29 +1597,102 @@ void binc_device_set_uuids(Device *device, GList *uuids) {
     g_assert(device != NULL);
 
     binc_device_free_uuids(device);
-    device->uuids = uuids;
+
+    // Store interned uuid strings so that service checks become pointer compares
+    for (GList *iterator = uuids; iterator; iterator = iterator->next) {
+        const char *interned_uuid = binc_uuid_intern_string((char *) iterator->data);
+        if (interned_uuid != NULL) {
+            device->uuids = g_list_append(device->uuids, (char *) interned_uuid);
+        }
+    }
+    g_list_free_full(uuids, g_free);
+}
+
+static GHashTable *binc_internal_decode_manufacturer_data(GVariant *variant) {
+    GVariantIter *iter;
+    g_variant_get(variant, "a{qv}", &iter);
+
+    GVariant *array;
+    guint16 key;
+    GHashTable *manufacturer_data = g_hash_table_new_full(g_int_hash, g_int_equal,
+                                                          g_free, (GDestroyNotify) byte_array_free);
+    while (g_variant_iter_loop(iter, "{qv}", &key, &array)) {
+        gsize data_length = 0;
+        guint8 *data = (guint8 *) g_variant_get_fixed_array(array, &data_length, sizeof(guint8));
+        GByteArray *byteArray = g_byte_array_sized_new((guint) data_length);
+        g_byte_array_append(byteArray, data, (guint) data_length);
+
+        int *keyCopy = g_new0 (gint, 1);
+        *keyCopy = key;
+
+        g_hash_table_insert(manufacturer_data, keyCopy, byteArray);
+    }
+    g_variant_iter_free(iter);
+    return manufacturer_data;
+}
+
+static GHashTable *binc_internal_decode_service_data(GVariant *variant) {
+    GVariantIter *iter;
+    g_variant_get(variant, "a{sv}", &iter);
+
+    GVariant *array;
+    char *key;
+    GHashTable *service_data = g_hash_table_new_full(g_str_hash, g_str_equal,
+                                                     g_free, (GDestroyNotify) byte_array_free);
+    while (g_variant_iter_loop(iter, "{sv}", &key, &array)) {
+        gsize data_length = 0;
+        guint8 *data = (guint8 *) g_variant_get_fixed_array(array, &data_length, sizeof(guint8));
+        GByteArray *byteArray = g_byte_array_sized_new((guint) data_length);
+        g_byte_array_append(byteArray, data, (guint) data_length);
+
+        char *keyCopy = g_strdup(key);
+
+        g_hash_table_insert(service_data, keyCopy, byteArray);
+    }
+    g_variant_iter_free(iter);
+    return service_data;
 }
 
 GHashTable *binc_device_get_manufacturer_data(const Device *device) {
     g_assert(device != NULL);
+
+    // Materialize on first access so filtered-out advertisements never pay for decoding
+    Device *self = (Device *) device;
+    if (self->manufacturer_data == NULL && self->manufacturer_data_variant != NULL) {
+        self->manufacturer_data = binc_internal_decode_manufacturer_data(self->manufacturer_data_variant);
+    }
     return device->manufacturer_data;
 }
 
 void binc_device_set_manufacturer_data(Device *device, GHashTable *manufacturer_data) {
     g_assert(device != NULL);
 
+    if (device->manufacturer_data_variant != NULL) {
+        g_variant_unref(device->manufacturer_data_variant);
+        device->manufacturer_data_variant = NULL;
+    }
     binc_device_free_manufacturer_data(device);
     device->manufacturer_data = manufacturer_data;
 }
 
 GHashTable *binc_device_get_service_data(const Device *device) {
     g_assert(device != NULL);
+
+    // Materialize on first access so filtered-out advertisements never pay for decoding
+    Device *self = (Device *) device;
+    if (self->service_data == NULL && self->service_data_variant != NULL) {
+        self->service_data = binc_internal_decode_service_data(self->service_data_variant);
+    }
     return device->service_data;
 }
 
 void binc_device_set_service_data(Device *device, GHashTable *service_data) {
     g_assert(device != NULL);
 
+    if (device->service_data_variant != NULL) {
+        g_variant_unref(device->service_data_variant);
+        device->service_data_variant = NULL;
+    }
     binc_device_free_service_data(device);
     device->service_data = service_data;
 }
@@ -1130,8 +1732,9 @@ gboolean binc_device_has_service(const Device *device, const char *service_uuid)
     g_assert(g_uuid_string_is_valid(service_uuid));
 
     if (device->uuids != NULL && g_list_length(device->uuids) > 0) {
+        const char *interned_uuid = binc_uuid_intern_string(service_uuid);
         for (GList *iterator = device->uuids; iterator; iterator = iterator->next) {
-            if (g_str_equal(service_uuid, (char *) iterator->data)) {
+            if (interned_uuid == (char *) iterator->data) {
                 return TRUE;
             }
         }
@@ -1139,7 +1742,21 @@ gboolean binc_device_has_service(const Device *device, const char *service_uuid)
     return FALSE;
 }
 
+gint64 binc_internal_device_get_last_seen(const Device *device) {
+    g_assert(device != NULL);
+    return device->last_seen;
+}
+
+Characteristic *binc_internal_device_lookup_characteristic(const Device *device, const char *path) {
+    g_assert(device != NULL);
+    g_assert(path != NULL);
+
+    if (device->characteristics == NULL) return NULL;
+    return g_hash_table_lookup(device->characteristics, path);
+}
+
 void binc_internal_device_update_property(Device *device, const char *property_name, GVariant *property_value) {
+    device->last_seen = g_get_monotonic_time();
     if (g_str_equal(property_name, DEVICE_PROPERTY_ADDRESS)) {
         binc_device_set_address(device, g_variant_get_string(property_value, NULL));
     } else if (g_str_equal(property_name, DEVICE_PROPERTY_ADDRESS_TYPE)) {
@@ -1162,47 +1779,19 @@ void binc_internal_device_update_property(Device *device, const char *property_n
     } else if (g_str_equal(property_name, DEVICE_PROPERTY_UUIDS)) {
         binc_device_set_uuids(device, g_variant_string_array_to_list(property_value));
     } else if (g_str_equal(property_name, DEVICE_PROPERTY_MANUFACTURER_DATA)) {
-        GVariantIter *iter;
-        g_variant_get(property_value, "a{qv}", &iter);
-
-        GVariant *array;
-        guint16 key;
-        GHashTable *manufacturer_data = g_hash_table_new_full(g_int_hash, g_int_equal,
-                                                              g_free, (GDestroyNotify) byte_array_free);
-        while (g_variant_iter_loop(iter, "{qv}", &key, &array)) {
-            gsize data_length = 0;
-            guint8 *data = (guint8 *) g_variant_get_fixed_array(array, &data_length, sizeof(guint8));
-            GByteArray *byteArray = g_byte_array_sized_new((guint) data_length);
-            g_byte_array_append(byteArray, data, (guint) data_length);
-
-            int *keyCopy = g_new0 (gint, 1);
-            *keyCopy = key;
-
-            g_hash_table_insert(manufacturer_data, keyCopy, byteArray);
+        // Only keep a ref to the variant, it is decoded on first access
+        if (device->manufacturer_data_variant != NULL) {
+            g_variant_unref(device->manufacturer_data_variant);
         }
-        binc_device_set_manufacturer_data(device, manufacturer_data);
-        g_variant_iter_free(iter);
+        device->manufacturer_data_variant = g_variant_ref(property_value);
+        binc_device_free_manufacturer_data(device);
     } else if (g_str_equal(property_name, DEVICE_PROPERTY_SERVICE_DATA)) {
-        GVariantIter *iter;
-        g_variant_get(property_value, "a{sv}", &iter);
-
-        GVariant *array;
-        char *key;
-
-        GHashTable *service_data = g_hash_table_new_full(g_str_hash, g_str_equal,
-                                                         g_free, (GDestroyNotify) byte_array_free);
-        while (g_variant_iter_loop(iter, "{sv}", &key, &array)) {
-            gsize data_length = 0;
-            guint8 *data = (guint8 *) g_variant_get_fixed_array(array, &data_length, sizeof(guint8));
-            GByteArray *byteArray = g_byte_array_sized_new((guint) data_length);
-            g_byte_array_append(byteArray, data, (guint) data_length);
-
-            char *keyCopy = g_strdup(key);
-
-            g_hash_table_insert(service_data, keyCopy, byteArray);
+        // Only keep a ref to the variant, it is decoded on first access
+        if (device->service_data_variant != NULL) {
+            g_variant_unref(device->service_data_variant);
         }
-        binc_device_set_service_data(device, service_data);
-        g_variant_iter_free(iter);
+        device->service_data_variant = g_variant_ref(property_value);
+        binc_device_free_service_data(device);
     }
 }
 
@@ -47,6 +47,23 @@ typedef void (*ServicesResolvedCallback)(Device *device);
 typedef void (*BondingStateChangedCallback)(Device *device, BondingState new_state, BondingState old_state,
                                             const GError *error);
 
+typedef void (*RangeStateChangedCallback)(Device *device, gboolean in_range);
+
+typedef void (*OnNotifyAllCompleteCallback)(Device *device, guint started, guint failed);
+
+/*
+ * One result of a bulk read. Either 'value' or 'error' is set, never both.
+ * The result and its contents are owned by the library and only valid while
+ * the completion callback runs.
+ */
+typedef struct binc_char_read_result {
+    Characteristic *characteristic; // Borrowed
+    GByteArray *value; // Owned, NULL on error
+    GError *error; // Owned, NULL on success
+} CharacteristicReadResult;
+
+typedef void (*OnReadAllCompleteCallback)(Device *device, GPtrArray *results);
+
 
 /**
  * Connect to a device asynchronously
@@ -65,6 +82,27 @@ void binc_device_set_read_char_cb(Device *device, OnReadCallback callback);
 
 gboolean binc_device_read_char(const Device *device, const char *service_uuid, const char *characteristic_uuid);
 
+/**
+ * Read a set of characteristics with a bounded number of ReadValue calls in
+ * flight.
+ *
+ * Reads are pipelined: at most 'max_in_flight' ReadValue calls run
+ * concurrently and the next characteristic is taken from the queue as soon as
+ * one settles, instead of serializing one round trip per characteristic.
+ * Individual results are still reported through the OnReadCallback; the
+ * completion callback receives an array of CharacteristicReadResult, one per
+ * characteristic read, valid only while the callback runs. Uuids that do not
+ * match a readable characteristic are skipped. Only one bulk read may run per
+ * device at a time.
+ *
+ * @param device the device, must have its services resolved
+ * @param characteristic_uuids characteristic uuids to read (borrowed)
+ * @param max_in_flight maximum concurrent ReadValue calls, 0 for the default (4)
+ * @param callback called with all results once the whole set has settled
+ */
+void binc_device_read_chars(Device *device, const GPtrArray *characteristic_uuids, guint max_in_flight,
+                            OnReadAllCompleteCallback callback);
+
 void binc_device_set_write_char_cb(Device *device, OnWriteCallback callback);
 
 gboolean binc_device_write_char(const Device *device, const char *service_uuid,
@@ -76,6 +114,25 @@ void binc_device_set_notify_state_cb(Device *device, OnNotifyingStateChangedCall
 
 gboolean binc_device_start_notify(const Device *device, const char *service_uuid, const char *characteristic_uuid);
 
+/**
+ * Subscribe to a set of characteristics with a bounded number of StartNotify
+ * calls in flight.
+ *
+ * Subscriptions are pipelined: at most 'max_in_flight' StartNotify calls run
+ * concurrently and the next characteristic is taken from the queue as soon as
+ * one settles. Characteristics that are already notifying are skipped and
+ * count as started. Individual state changes are still reported through the
+ * OnNotifyingStateChangedCallback; the completion callback fires once when
+ * the whole set has settled. Only one batch may run per device at a time.
+ *
+ * @param device the device, must have its services resolved
+ * @param characteristic_uuids characteristic uuids to subscribe to (borrowed)
+ * @param max_in_flight maximum concurrent StartNotify calls, 0 for the default (4)
+ * @param callback called when all subscriptions have settled, or NULL
+ */
+void binc_device_start_notify_all(Device *device, const GPtrArray *characteristic_uuids, guint max_in_flight,
+                                  OnNotifyAllCompleteCallback callback);
+
 gboolean binc_device_stop_notify(const Device *device, const char *service_uuid, const char *characteristic_uuid);
 
 gboolean binc_device_read_desc(const Device *device, const char *service_uuid,
@@ -121,6 +178,42 @@ gboolean binc_device_get_paired(const Device *device);
 
 short binc_device_get_rssi(const Device *device);
 
+/**
+ * Get the smoothed RSSI of this device.
+ *
+ * Every RSSI sample is folded into an exponentially weighted moving average
+ * as it arrives, so reading the filtered value is free. Returns the raw RSSI
+ * until the first sample has been seen. The smoothing window can be tuned
+ * with binc_device_set_rssi_filter_window().
+ *
+ * @param device the device
+ * @return the smoothed RSSI in dBm
+ */
+short binc_device_get_filtered_rssi(const Device *device);
+
+/**
+ * Set the smoothing window for the filtered RSSI, in samples (default 8).
+ * Larger windows respond more slowly but suppress more noise.
+ */
+void binc_device_set_rssi_filter_window(Device *device, guint window);
+
+/**
+ * Get a callback when the device enters or leaves range.
+ *
+ * The filtered RSSI is compared against the thresholds on every sample:
+ * the device is 'in range' once the filtered RSSI reaches 'enter_rssi' and
+ * 'out of range' once it drops below 'exit_rssi'. Keeping exit_rssi a few
+ * dBm below enter_rssi gives hysteresis that prevents flapping at the edge
+ * of range. Pass NULL to remove the callback.
+ *
+ * @param device the device
+ * @param enter_rssi RSSI in dBm at which the device counts as in range
+ * @param exit_rssi RSSI in dBm below which the device counts as out of range, must be <= enter_rssi
+ * @param callback the callback, or NULL
+ */
+void binc_device_set_range_cb(Device *device, short enter_rssi, short exit_rssi,
+                              RangeStateChangedCallback callback);
+
 gboolean binc_device_get_trusted(const Device *device);
 
 short binc_device_get_txpower(const Device *device);
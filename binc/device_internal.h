@@ -60,8 +60,20 @@ void binc_device_set_service_data(Device *device, GHashTable *service_data);
 
 void binc_device_set_bonding_state(Device *device, BondingState bonding_state);
 
+// Observes bonding state changes in addition to the application's
+// BondingStateChangedCallback; used by the agent's bonding pipeline
+typedef void (*BondingStateObserver)(Device *device, gpointer user_data);
+
+void binc_internal_device_set_bonding_observer(Device *device, BondingStateObserver observer, gpointer user_data);
+
 void binc_device_set_is_central(Device *device, gboolean is_central);
 
 void binc_internal_device_update_property(Device *device, const char *property_name, GVariant *property_value);
 
+gint64 binc_internal_device_get_last_seen(const Device *device);
+
+void binc_internal_device_handle_properties_changed(Device *device, GVariant *params);
+
+Characteristic *binc_internal_device_lookup_characteristic(const Device *device, const char *path);
+
 #endif //BINC_DEVICE_INTERNAL_H
@@ -0,0 +1,149 @@
+/*
+ *   Copyright (c) 2022 Martijn van Welie
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy
+ *   of this software and associated documentation files (the "Software"), to deal
+ *   in the Software without restriction, including without limitation the rights
+ *   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *   copies of the Software, and to permit persons to whom the Software is
+ *   furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included in all
+ *   copies or substantial portions of the Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *   SOFTWARE.
+ *
+ */
+
+#include "executor.h"
+#include "logger.h"
+
+static const char *const TAG = "Executor";
+
+struct binc_callback_executor {
+    GThreadPool *pool; // Owned
+    GMutex mutex;
+    GHashTable *serial_queues; // Owned, serial key -> GQueue of pending TaskItems
+};
+
+typedef struct binc_executor_task_item {
+    CallbackExecutor *executor; // Borrowed
+    char *serial_key; // Owned
+    ExecutorTask task;
+    gpointer task_data;
+} TaskItem;
+
+static void binc_internal_task_item_free(TaskItem *item) {
+    g_free(item->serial_key);
+    g_free(item);
+}
+
+static void binc_internal_executor_worker(gpointer data, gpointer user_data) {
+    TaskItem *item = (TaskItem *) data;
+    CallbackExecutor *executor = item->executor;
+
+    item->task(item->task_data);
+
+    // Hand the next task for this serial key to the pool, or retire the key
+    g_mutex_lock(&executor->mutex);
+    GQueue *queue = g_hash_table_lookup(executor->serial_queues, item->serial_key);
+    g_assert(queue != NULL);
+    TaskItem *next = g_queue_pop_head(queue);
+    if (next != NULL) {
+        g_thread_pool_push(executor->pool, next, NULL);
+    } else {
+        g_hash_table_remove(executor->serial_queues, item->serial_key);
+    }
+    g_mutex_unlock(&executor->mutex);
+
+    binc_internal_task_item_free(item);
+}
+
+CallbackExecutor *binc_callback_executor_create(guint num_threads) {
+    GError *error = NULL;
+    CallbackExecutor *executor = g_new0(CallbackExecutor, 1);
+    g_mutex_init(&executor->mutex);
+    executor->serial_queues = g_hash_table_new_full(g_str_hash, g_str_equal,
+                                                    g_free, (GDestroyNotify) g_queue_free);
+    executor->pool = g_thread_pool_new(binc_internal_executor_worker,
+                                       executor,
+                                       num_threads > 0 ? (gint) num_threads : (gint) g_get_num_processors(),
+                                       FALSE,
+                                       &error);
+    if (error != NULL) {
+        log_debug(TAG, "failed to create thread pool (error %d: %s)", error->code, error->message);
+        g_clear_error(&error);
+        g_hash_table_destroy(executor->serial_queues);
+        g_mutex_clear(&executor->mutex);
+        g_free(executor);
+        return NULL;
+    }
+    return executor;
+}
+
+void binc_callback_executor_submit(CallbackExecutor *executor, const char *serial_key,
+                                   ExecutorTask task, gpointer task_data) {
+    g_assert(executor != NULL);
+    g_assert(serial_key != NULL);
+    g_assert(task != NULL);
+
+    TaskItem *item = g_new0(TaskItem, 1);
+    item->executor = executor;
+    item->serial_key = g_strdup(serial_key);
+    item->task = task;
+    item->task_data = task_data;
+
+    // A key is present in serial_queues while a task for it is running, so a
+    // queued entry is only handed to the pool once its predecessor finished
+    g_mutex_lock(&executor->mutex);
+    GQueue *queue = g_hash_table_lookup(executor->serial_queues, serial_key);
+    if (queue != NULL) {
+        g_queue_push_tail(queue, item);
+    } else {
+        g_hash_table_insert(executor->serial_queues, g_strdup(serial_key), g_queue_new());
+        g_thread_pool_push(executor->pool, item, NULL);
+    }
+    g_mutex_unlock(&executor->mutex);
+}
+
+void binc_callback_executor_drain(CallbackExecutor *executor, const char *serial_key) {
+    g_assert(executor != NULL);
+    g_assert(serial_key != NULL);
+
+    // A key is present in serial_queues while a task for it is running or
+    // pending, so once it is gone nothing references the key's object anymore
+    while (TRUE) {
+        g_mutex_lock(&executor->mutex);
+        gboolean busy = g_hash_table_contains(executor->serial_queues, serial_key);
+        g_mutex_unlock(&executor->mutex);
+        if (!busy) break;
+        g_usleep(1000);
+    }
+}
+
+void binc_callback_executor_free(CallbackExecutor *executor) {
+    g_assert(executor != NULL);
+
+    // Serial keys disappear when their last task completed, so an empty table
+    // means nothing is running or pending and the pool can be torn down safely
+    while (TRUE) {
+        g_mutex_lock(&executor->mutex);
+        guint pending = g_hash_table_size(executor->serial_queues);
+        g_mutex_unlock(&executor->mutex);
+        if (pending == 0) break;
+        g_usleep(1000);
+    }
+
+    g_thread_pool_free(executor->pool, FALSE, TRUE);
+    executor->pool = NULL;
+    g_hash_table_destroy(executor->serial_queues);
+    executor->serial_queues = NULL;
+    g_mutex_clear(&executor->mutex);
+    g_free(executor);
+}
@@ -0,0 +1,83 @@
+/*
+ *   Copyright (c) 2022 Martijn van Welie
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy
+ *   of this software and associated documentation files (the "Software"), to deal
+ *   in the Software without restriction, including without limitation the rights
+ *   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *   copies of the Software, and to permit persons to whom the Software is
+ *   furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included in all
+ *   copies or substantial portions of the Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *   SOFTWARE.
+ *
+ */
+
+#ifndef BINC_EXECUTOR_H
+#define BINC_EXECUTOR_H
+
+#include <glib.h>
+#include "forward_decl.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef void (*ExecutorTask)(gpointer task_data);
+
+/**
+ * Create a callback executor backed by a thread pool.
+ *
+ * Tasks submitted with the same serial key run strictly in submission order,
+ * never concurrently with each other; tasks with different keys run in
+ * parallel across the pool. Used by the adapter to move user callbacks off
+ * the GMainLoop thread while preserving per-device ordering (see
+ * binc_adapter_set_callback_executor).
+ *
+ * @param num_threads number of worker threads, 0 for one thread per core
+ * @return executor object, free with binc_callback_executor_free()
+ */
+CallbackExecutor *binc_callback_executor_create(guint num_threads);
+
+/**
+ * Submit a task. The task owns 'task_data' and must free it when done.
+ *
+ * @param executor the executor
+ * @param serial_key tasks sharing this key run serially in submission order
+ * @param task the function to run on a worker thread
+ * @param task_data passed to the task
+ */
+void binc_callback_executor_submit(CallbackExecutor *executor, const char *serial_key,
+                                   ExecutorTask task, gpointer task_data);
+
+/**
+ * Wait until all tasks for one serial key have finished.
+ *
+ * Used before freeing an object that queued tasks still reference (e.g. a
+ * device about to be removed): returns once nothing for 'serial_key' is
+ * running or pending anymore. New tasks for the key must not be submitted
+ * while draining.
+ *
+ * @param executor the executor
+ * @param serial_key the serial key to drain
+ */
+void binc_callback_executor_drain(CallbackExecutor *executor, const char *serial_key);
+
+/**
+ * Free the executor. Waits for all queued tasks to finish.
+ */
+void binc_callback_executor_free(CallbackExecutor *executor);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //BINC_EXECUTOR_H
@@ -36,6 +36,10 @@ typedef struct binc_characteristic Characteristic;
 typedef struct binc_descriptor Descriptor;
 typedef struct binc_service_handler_manager ServiceHandlerManager;
 typedef struct binc_advertisement Advertisement;
+typedef struct binc_object_manager_cache ObjectManagerCache;
+typedef struct binc_gatt_cache_builder GattCacheBuilder;
+typedef struct binc_callback_executor CallbackExecutor;
+typedef struct binc_scan_coordinator ScanCoordinator;
 typedef struct binc_application Application;
 
 #ifdef __cplusplus
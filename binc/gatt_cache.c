@@ -0,0 +1,244 @@
+/*
+ *   Copyright (c) 2022 Martijn van Welie
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy
+ *   of this software and associated documentation files (the "Software"), to deal
+ *   in the Software without restriction, including without limitation the rights
+ *   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *   copies of the Software, and to permit persons to whom the Software is
+ *   furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included in all
+ *   copies or substantial portions of the Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *   SOFTWARE.
+ *
+ */
+
+#include "gatt_cache.h"
+#include "logger.h"
+#include "utility.h"
+
+static const char *const TAG = "GattCache";
+static const char *const INTERFACE_SERVICE = "org.bluez.GattService1";
+static const char *const INTERFACE_CHARACTERISTIC = "org.bluez.GattCharacteristic1";
+static const char *const INTERFACE_DESCRIPTOR = "org.bluez.GattDescriptor1";
+
+static const char *const KEY_INTERFACE = "Interface";
+static const char *const KEY_UUID = "UUID";
+static const char *const KEY_SERVICE = "Service";
+static const char *const KEY_CHARACTERISTIC = "Characteristic";
+static const char *const KEY_FLAGS = "Flags";
+
+static char *cache_directory = NULL;
+
+struct binc_gatt_cache_builder {
+    GKeyFile *key_file; // Owned
+};
+
+void binc_gatt_cache_set_directory(const char *directory) {
+    g_free(cache_directory);
+    cache_directory = g_strdup(directory);
+
+    if (cache_directory != NULL) {
+        g_mkdir_with_parents(cache_directory, 0700);
+    }
+}
+
+gboolean binc_gatt_cache_is_enabled(void) {
+    return cache_directory != NULL;
+}
+
+static char *binc_internal_gatt_cache_filename(const char *address) {
+    g_assert(address != NULL);
+
+    char *filename = g_strdup_printf("%s/%s.gatt", cache_directory, address);
+    return replace_char(filename, ':', '_');
+}
+
+gboolean binc_gatt_cache_exists(const char *address) {
+    g_assert(address != NULL);
+
+    if (cache_directory == NULL) return FALSE;
+
+    char *filename = binc_internal_gatt_cache_filename(address);
+    gboolean exists = g_file_test(filename, G_FILE_TEST_IS_REGULAR);
+    g_free(filename);
+    return exists;
+}
+
+void binc_gatt_cache_remove(const char *address) {
+    g_assert(address != NULL);
+
+    if (cache_directory == NULL) return;
+
+    char *filename = binc_internal_gatt_cache_filename(address);
+    remove(filename);
+    g_free(filename);
+}
+
+static void binc_internal_gatt_cache_deliver(GKeyFile *key_file, const char *interface_name,
+                                             GattCacheObjectFunc func, gpointer user_data) {
+    gsize group_count = 0;
+    char **groups = g_key_file_get_groups(key_file, &group_count);
+
+    for (gsize i = 0; i < group_count; i++) {
+        const char *object_path = groups[i];
+        char *iface = g_key_file_get_string(key_file, object_path, KEY_INTERFACE, NULL);
+        if (iface == NULL || !g_str_equal(iface, interface_name)) {
+            g_free(iface);
+            continue;
+        }
+
+        GVariantBuilder *properties_builder = g_variant_builder_new(G_VARIANT_TYPE("a{sv}"));
+        char *uuid = g_key_file_get_string(key_file, object_path, KEY_UUID, NULL);
+        if (uuid != NULL) {
+            g_variant_builder_add(properties_builder, "{sv}", KEY_UUID, g_variant_new_string(uuid));
+            g_free(uuid);
+        }
+
+        char *service_path = g_key_file_get_string(key_file, object_path, KEY_SERVICE, NULL);
+        if (service_path != NULL) {
+            g_variant_builder_add(properties_builder, "{sv}", KEY_SERVICE, g_variant_new_string(service_path));
+            g_free(service_path);
+        }
+
+        char *characteristic_path = g_key_file_get_string(key_file, object_path, KEY_CHARACTERISTIC, NULL);
+        if (characteristic_path != NULL) {
+            g_variant_builder_add(properties_builder, "{sv}", KEY_CHARACTERISTIC,
+                                  g_variant_new_string(characteristic_path));
+            g_free(characteristic_path);
+        }
+
+        gsize flag_count = 0;
+        char **flags = g_key_file_get_string_list(key_file, object_path, KEY_FLAGS, &flag_count, NULL);
+        if (flags != NULL) {
+            g_variant_builder_add(properties_builder, "{sv}", KEY_FLAGS,
+                                  g_variant_new_strv((const char *const *) flags, (gssize) flag_count));
+            g_strfreev(flags);
+        }
+
+        GVariant *properties = g_variant_ref_sink(g_variant_builder_end(properties_builder));
+        g_variant_builder_unref(properties_builder);
+
+        func(object_path, interface_name, properties, user_data);
+        g_variant_unref(properties);
+        g_free(iface);
+    }
+
+    g_strfreev(groups);
+}
+
+gboolean binc_gatt_cache_load(const char *address, GattCacheObjectFunc func, gpointer user_data) {
+    g_assert(address != NULL);
+    g_assert(func != NULL);
+
+    if (cache_directory == NULL) return FALSE;
+
+    char *filename = binc_internal_gatt_cache_filename(address);
+    GKeyFile *key_file = g_key_file_new();
+
+    GError *error = NULL;
+    if (!g_key_file_load_from_file(key_file, filename, G_KEY_FILE_NONE, &error)) {
+        log_debug(TAG, "failed to load gatt cache for '%s' (%s)", address, error->message);
+        g_clear_error(&error);
+        g_key_file_free(key_file);
+        g_free(filename);
+        return FALSE;
+    }
+
+    // Three passes so that services are delivered before their characteristics,
+    // and characteristics before their descriptors
+    binc_internal_gatt_cache_deliver(key_file, INTERFACE_SERVICE, func, user_data);
+    binc_internal_gatt_cache_deliver(key_file, INTERFACE_CHARACTERISTIC, func, user_data);
+    binc_internal_gatt_cache_deliver(key_file, INTERFACE_DESCRIPTOR, func, user_data);
+
+    g_key_file_free(key_file);
+    g_free(filename);
+    return TRUE;
+}
+
+GattCacheBuilder *binc_gatt_cache_builder_create(void) {
+    GattCacheBuilder *builder = g_new0(GattCacheBuilder, 1);
+    builder->key_file = g_key_file_new();
+    return builder;
+}
+
+static void binc_internal_builder_set_flags(GattCacheBuilder *builder, const char *object_path, GList *flags) {
+    guint flag_count = g_list_length(flags);
+    if (flag_count == 0) return;
+
+    const char **flag_array = g_new0(const char *, flag_count);
+    guint index = 0;
+    for (GList *iterator = flags; iterator; iterator = iterator->next) {
+        flag_array[index++] = (const char *) iterator->data;
+    }
+    g_key_file_set_string_list(builder->key_file, object_path, KEY_FLAGS, flag_array, flag_count);
+    g_free(flag_array);
+}
+
+void binc_gatt_cache_builder_add_service(GattCacheBuilder *builder, const char *object_path, const char *uuid) {
+    g_assert(builder != NULL);
+    g_assert(object_path != NULL);
+    g_assert(uuid != NULL);
+
+    g_key_file_set_string(builder->key_file, object_path, KEY_INTERFACE, INTERFACE_SERVICE);
+    g_key_file_set_string(builder->key_file, object_path, KEY_UUID, uuid);
+}
+
+void binc_gatt_cache_builder_add_characteristic(GattCacheBuilder *builder, const char *object_path,
+                                                const char *service_path, const char *uuid, GList *flags) {
+    g_assert(builder != NULL);
+    g_assert(object_path != NULL);
+    g_assert(service_path != NULL);
+    g_assert(uuid != NULL);
+
+    g_key_file_set_string(builder->key_file, object_path, KEY_INTERFACE, INTERFACE_CHARACTERISTIC);
+    g_key_file_set_string(builder->key_file, object_path, KEY_UUID, uuid);
+    g_key_file_set_string(builder->key_file, object_path, KEY_SERVICE, service_path);
+    binc_internal_builder_set_flags(builder, object_path, flags);
+}
+
+void binc_gatt_cache_builder_add_descriptor(GattCacheBuilder *builder, const char *object_path,
+                                            const char *characteristic_path, const char *uuid, GList *flags) {
+    g_assert(builder != NULL);
+    g_assert(object_path != NULL);
+    g_assert(characteristic_path != NULL);
+    g_assert(uuid != NULL);
+
+    g_key_file_set_string(builder->key_file, object_path, KEY_INTERFACE, INTERFACE_DESCRIPTOR);
+    g_key_file_set_string(builder->key_file, object_path, KEY_UUID, uuid);
+    g_key_file_set_string(builder->key_file, object_path, KEY_CHARACTERISTIC, characteristic_path);
+    binc_internal_builder_set_flags(builder, object_path, flags);
+}
+
+gboolean binc_gatt_cache_builder_store(GattCacheBuilder *builder, const char *address) {
+    g_assert(builder != NULL);
+    g_assert(address != NULL);
+
+    if (cache_directory == NULL) return FALSE;
+
+    char *filename = binc_internal_gatt_cache_filename(address);
+    GError *error = NULL;
+    gboolean success = g_key_file_save_to_file(builder->key_file, filename, &error);
+    if (!success) {
+        log_debug(TAG, "failed to store gatt cache for '%s' (%s)", address, error->message);
+        g_clear_error(&error);
+    }
+    g_free(filename);
+    return success;
+}
+
+void binc_gatt_cache_builder_free(GattCacheBuilder *builder) {
+    g_assert(builder != NULL);
+
+    g_key_file_free(builder->key_file);
+    builder->key_file = NULL;
+    g_free(builder);
+}
@@ -0,0 +1,83 @@
+/*
+ *   Copyright (c) 2022 Martijn van Welie
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy
+ *   of this software and associated documentation files (the "Software"), to deal
+ *   in the Software without restriction, including without limitation the rights
+ *   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *   copies of the Software, and to permit persons to whom the Software is
+ *   furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included in all
+ *   copies or substantial portions of the Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *   SOFTWARE.
+ *
+ */
+
+#ifndef BINC_GATT_CACHE_H
+#define BINC_GATT_CACHE_H
+
+#include <gio/gio.h>
+#include "forward_decl.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef void (*GattCacheObjectFunc)(const char *object_path, const char *interface_name,
+                                    GVariant *properties, gpointer user_data);
+
+/**
+ * Enable the on-disk GATT cache by setting the directory to store cache files in.
+ *
+ * When enabled, the resolved GATT tree of a device is written to disk on
+ * disconnect and restored on the next connect, so the services resolved
+ * callback fires without waiting for BlueZ's service resolution. The cache is
+ * refreshed after every real service resolution; a stale entry is dropped when
+ * it can no longer be read. The directory is created when needed.
+ *
+ * @param directory directory for cache files, or NULL to disable caching (the default)
+ */
+void binc_gatt_cache_set_directory(const char *directory);
+
+gboolean binc_gatt_cache_is_enabled(void);
+
+gboolean binc_gatt_cache_exists(const char *address);
+
+void binc_gatt_cache_remove(const char *address);
+
+/**
+ * Load a cached GATT tree, invoking 'func' once per object with BlueZ-style
+ * properties ('UUID', 'Service', 'Characteristic', 'Flags'). Objects are
+ * delivered services first, then characteristics, then descriptors.
+ *
+ * @return TRUE if the cache file was read successfully
+ */
+gboolean binc_gatt_cache_load(const char *address, GattCacheObjectFunc func, gpointer user_data);
+
+GattCacheBuilder *binc_gatt_cache_builder_create(void);
+
+void binc_gatt_cache_builder_add_service(GattCacheBuilder *builder, const char *object_path, const char *uuid);
+
+void binc_gatt_cache_builder_add_characteristic(GattCacheBuilder *builder, const char *object_path,
+                                                const char *service_path, const char *uuid, GList *flags);
+
+void binc_gatt_cache_builder_add_descriptor(GattCacheBuilder *builder, const char *object_path,
+                                            const char *characteristic_path, const char *uuid, GList *flags);
+
+gboolean binc_gatt_cache_builder_store(GattCacheBuilder *builder, const char *address);
+
+void binc_gatt_cache_builder_free(GattCacheBuilder *builder);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //BINC_GATT_CACHE_H
@@ -32,6 +32,10 @@
 #define MAX_FILE_SIZE 1024 * 64
 #define MAX_LOGS 5
 
+// Must be a power of two so indexes can wrap with a mask
+#define LOG_RING_SIZE 256
+#define MAX_TAG_LENGTH 31
+
 static struct {
     gboolean enabled;
     LogLevel level;
@@ -41,7 +45,12 @@ static struct {
     unsigned int maxFiles;
     size_t currentSize;
     LogEventCallback logCallback;
-} LogSettings = {TRUE, LOG_DEBUG, NULL, "", MAX_FILE_SIZE, MAX_LOGS, 0, NULL};
+    gboolean async;
+} LogSettings = {TRUE, LOG_DEBUG, NULL, "", MAX_FILE_SIZE, MAX_LOGS, 0, NULL, FALSE};
+
+// Mirrors LogSettings.enabled/level so the log macros can reject disabled
+// levels with one atomic read, before any call or argument setup happens
+gint log_effective_threshold = LOG_DEBUG;
 
 static const char *log_level_names[] = {
         [LOG_DEBUG] = "DEBUG",
@@ -50,8 +59,36 @@ static const char *log_level_names[] = {
         [LOG_ERROR]  = "ERROR"
 };
 
+/*
+ * Async mode: the hot path claims a slot in a fixed-size lock-free ring
+ * (bounded MPMC scheme using per-slot sequence numbers) and formats into it
+ * without any allocation. A background flusher thread drains the ring in
+ * batches, does the file writes and handles rotation. When the ring is full
+ * the record is dropped and counted instead of blocking the caller.
+ */
+typedef struct {
+    gint sequence;
+    LogLevel level;
+    long long millis;
+    char tag[MAX_TAG_LENGTH + 1];
+    char message[BUFFER_SIZE];
+} LogRecord;
+
+static LogRecord log_ring[LOG_RING_SIZE];
+static gint ring_enqueue_pos = 0;
+static gint ring_dequeue_pos = 0; // Only touched by the flusher thread
+static gint log_dropped_count = 0;
+static gint flusher_running = 0;
+static GThread *flusher_thread = NULL;
+
+static void update_effective_threshold(void) {
+    g_atomic_int_set(&log_effective_threshold,
+                     LogSettings.enabled ? (gint) LogSettings.level : (gint) LOG_ERROR + 1);
+}
+
 void log_set_level(LogLevel level) {
     LogSettings.level = level;
+    update_effective_threshold();
 }
 
 void log_set_handler(LogEventCallback callback) {
@@ -60,6 +97,7 @@ void log_set_handler(LogEventCallback callback) {
 
 void log_enabled(gboolean enabled) {
     LogSettings.enabled = enabled;
+    update_effective_threshold();
 }
 
 static void open_log_file(void) {
@@ -96,25 +134,24 @@ static long long current_timestamp_in_millis(void) {
 }
 
 /**
- * Returns a string representation of the current time year-month-day hours:minutes:seconds
+ * Returns a string representation of a timestamp year-month-day hours:minutes:seconds
  * @return newly allocated string, must be freed using g_free()
  */
-static char *current_time_string(void) {
-    GDateTime *now = g_date_time_new_now_local();
-    char *time_string = g_date_time_format(now, "%F %R:%S");
-    g_date_time_unref(now);
+static char *time_string_from_millis(long long millis) {
+    GDateTime *moment = g_date_time_new_from_unix_local(millis / 1000);
+    char *time_string = g_date_time_format(moment, "%F %R:%S");
+    g_date_time_unref(moment);
 
-    char *result = g_strdup_printf("%s:%03lld", time_string, current_timestamp_in_millis() % 1000);
+    char *result = g_strdup_printf("%s:%03lld", time_string, millis % 1000);
     g_free(time_string);
     return result;
 }
 
-static void log_log(const char *tag, const char *level, const char *message) {
-    char *timestamp = current_time_string();
+static void log_log(const char *tag, const char *level, const char *message, long long millis) {
+    char *timestamp = time_string_from_millis(millis);
     int bytes_written;
     if ((bytes_written = fprintf(LogSettings.fout, "%s %s [%s] %s\n", timestamp, level, tag, message)) > 0) {
         LogSettings.currentSize += (unsigned int) bytes_written;
-        fflush(LogSettings.fout);
     }
 
     g_free(timestamp);
@@ -167,25 +204,129 @@ static void rotate_log_file_if_needed(void) {
     open_log_file();
 }
 
-void log_log_at_level(LogLevel level, const char *tag, const char *format, ...) {
-    // Init fout to stdout if needed
-    if (LogSettings.fout == NULL && LogSettings.logCallback == NULL) {
-        LogSettings.fout = stdout;
+static void log_ring_enqueue(LogLevel level, const char *tag, const char *format, va_list args) {
+    for (;;) {
+        gint pos = g_atomic_int_get(&ring_enqueue_pos);
+        LogRecord *record = &log_ring[pos & (LOG_RING_SIZE - 1)];
+        gint dif = g_atomic_int_get(&record->sequence) - pos;
+
+        if (dif == 0) {
+            if (g_atomic_int_compare_and_exchange(&ring_enqueue_pos, pos, pos + 1)) {
+                record->level = level;
+                record->millis = current_timestamp_in_millis();
+                strncpy(record->tag, tag, MAX_TAG_LENGTH);
+                record->tag[MAX_TAG_LENGTH] = 0;
+                g_vsnprintf(record->message, BUFFER_SIZE, format, args);
+                g_atomic_int_set(&record->sequence, pos + 1);
+                return;
+            }
+        } else if (dif < 0) {
+            // Ring is full, drop the record rather than stall the caller
+            g_atomic_int_inc(&log_dropped_count);
+            return;
+        }
+        // Another producer claimed this slot first, retry
     }
+}
+
+static gboolean log_ring_dequeue(LogRecord *out) {
+    gint pos = ring_dequeue_pos;
+    LogRecord *record = &log_ring[pos & (LOG_RING_SIZE - 1)];
+    if (g_atomic_int_get(&record->sequence) != pos + 1) return FALSE;
+
+    *out = *record;
+    g_atomic_int_set(&record->sequence, pos + LOG_RING_SIZE);
+    ring_dequeue_pos = pos + 1;
+    return TRUE;
+}
 
-    rotate_log_file_if_needed();
+static gboolean log_flush_ring(void) {
+    LogRecord record;
+    gboolean wrote = FALSE;
 
-    if (LogSettings.level <= level && LogSettings.enabled) {
-        char buf[BUFFER_SIZE];
-        va_list arg;
-        va_start(arg, format);
-        g_vsnprintf(buf, BUFFER_SIZE, format, arg);
+    while (log_ring_dequeue(&record)) {
         if (LogSettings.logCallback) {
-            LogSettings.logCallback(level, tag, buf);
+            LogSettings.logCallback(record.level, record.tag, record.message);
         } else {
-            log_log(tag, log_level_names[level], buf);
+            if (LogSettings.fout == NULL) {
+                LogSettings.fout = stdout;
+            }
+            rotate_log_file_if_needed();
+            log_log(record.tag, log_level_names[record.level], record.message, record.millis);
+            wrote = TRUE;
         }
+    }
+    return wrote;
+}
+
+static gpointer log_flusher_loop(__attribute__((unused)) gpointer data) {
+    while (g_atomic_int_get(&flusher_running)) {
+        if (log_flush_ring() && LogSettings.fout != NULL) {
+            fflush(LogSettings.fout);
+        }
+        g_usleep(2000);
+    }
+
+    // Drain whatever is still in the ring before exiting
+    if (log_flush_ring() && LogSettings.fout != NULL) {
+        fflush(LogSettings.fout);
+    }
+    return NULL;
+}
+
+void log_set_async(gboolean async) {
+    if (async == LogSettings.async) return;
+
+    if (async) {
+        for (int i = 0; i < LOG_RING_SIZE; i++) {
+            g_atomic_int_set(&log_ring[i].sequence, i);
+        }
+        ring_enqueue_pos = 0;
+        ring_dequeue_pos = 0;
+        g_atomic_int_set(&flusher_running, 1);
+        LogSettings.async = TRUE;
+        flusher_thread = g_thread_new("binc-logger", log_flusher_loop, NULL);
+    } else {
+        LogSettings.async = FALSE;
+        g_atomic_int_set(&flusher_running, 0);
+        if (flusher_thread != NULL) {
+            g_thread_join(flusher_thread);
+            flusher_thread = NULL;
+        }
+    }
+}
+
+unsigned int log_get_dropped(void) {
+    return (unsigned int) g_atomic_int_get(&log_dropped_count);
+}
+
+void log_log_at_level(LogLevel level, const char *tag, const char *format, ...) {
+    // The log macros already filter on level; keep a check for direct callers
+    if (!log_is_enabled(level)) return;
+
+    va_list arg;
+    va_start(arg, format);
+
+    if (LogSettings.async) {
+        log_ring_enqueue(level, tag, format, arg);
         va_end(arg);
+        return;
+    }
+
+    char buf[BUFFER_SIZE];
+    g_vsnprintf(buf, BUFFER_SIZE, format, arg);
+    va_end(arg);
+
+    if (LogSettings.logCallback) {
+        LogSettings.logCallback(level, tag, buf);
+    } else {
+        // Only the file sink pays for the rotation stat and the flush
+        if (LogSettings.fout == NULL) {
+            LogSettings.fout = stdout;
+        }
+        rotate_log_file_if_needed();
+        log_log(tag, log_level_names[level], buf, current_timestamp_in_millis());
+        fflush(LogSettings.fout);
     }
 }
 
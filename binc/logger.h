@@ -34,10 +34,43 @@ typedef enum LogLevel {
     LOG_DEBUG = 0, LOG_INFO = 1, LOG_WARN = 2, LOG_ERROR = 3
 } LogLevel;
 
-#define log_debug(tag, format, ...) log_log_at_level(LOG_DEBUG, tag, format, ##__VA_ARGS__)
-#define log_info(tag, format, ...)  log_log_at_level(LOG_INFO, tag, format, ##__VA_ARGS__)
-#define log_warn(tag, format, ...)  log_log_at_level(LOG_WARN, tag, format,  ##__VA_ARGS__)
-#define log_error(tag, format, ...) log_log_at_level(LOG_ERROR, tag, format, ##__VA_ARGS__)
+// Effective log threshold, combining log_set_level() and log_enabled()
+// (LOG_ERROR + 1 when logging is disabled). Read it through log_is_enabled(),
+// never write it directly.
+extern gint log_effective_threshold; // make this internal
+
+/**
+ * Check whether a message at the given level would actually be logged.
+ * Use this to skip building expensive log arguments (e.g. hex dumps).
+ * This is a single comparison, cheap enough for any hot path.
+ */
+#define log_is_enabled(level) ((gint) (level) >= g_atomic_int_get(&log_effective_threshold))
+
+// Rejected levels are filtered here, before the call and its argument
+// evaluation for varargs setup, so a disabled log_debug costs one comparison
+#define log_debug(tag, format, ...) \
+    do { if (log_is_enabled(LOG_DEBUG)) log_log_at_level(LOG_DEBUG, tag, format, ##__VA_ARGS__); } while (0)
+#define log_info(tag, format, ...) \
+    do { if (log_is_enabled(LOG_INFO)) log_log_at_level(LOG_INFO, tag, format, ##__VA_ARGS__); } while (0)
+#define log_warn(tag, format, ...) \
+    do { if (log_is_enabled(LOG_WARN)) log_log_at_level(LOG_WARN, tag, format, ##__VA_ARGS__); } while (0)
+#define log_error(tag, format, ...) \
+    do { if (log_is_enabled(LOG_ERROR)) log_log_at_level(LOG_ERROR, tag, format, ##__VA_ARGS__); } while (0)
+
+/**
+ * Log a byte array as a hex dump at LOG_DEBUG. 'format' must contain a single
+ * '%s' that receives the hex dump. The dump is only rendered when LOG_DEBUG
+ * is enabled, so this is free on release configurations. Requires utility.h
+ * for g_byte_array_as_hex().
+ */
+#define log_debug_hex(tag, byteArray, format, ...)                                          \
+    do {                                                                                    \
+        if (log_is_enabled(LOG_DEBUG)) {                                                    \
+            GString *log_hex_string_ = g_byte_array_as_hex(byteArray);                      \
+            log_log_at_level(LOG_DEBUG, tag, format, log_hex_string_->str, ##__VA_ARGS__);  \
+            g_string_free(log_hex_string_, TRUE);                                           \
+        }                                                                                   \
+    } while (0)
 
 void log_log_at_level(LogLevel level, const char* tag, const char *format, ...);
 
@@ -51,6 +84,21 @@ void log_set_handler(LogEventCallback callback);
 
 void log_enabled(gboolean enabled);
 
+/**
+ * Enable or disable asynchronous logging.
+ *
+ * When enabled, log records are written into a fixed-size lock-free ring
+ * buffer without allocating and a background thread does the formatting to
+ * file, flushing and rotation. Records are dropped (and counted) when the
+ * ring is full. Disabling joins the background thread after draining.
+ */
+void log_set_async(gboolean async);
+
+/**
+ * Get the number of log records dropped because the async ring was full.
+ */
+unsigned int log_get_dropped(void);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,291 @@
+/*
+ *   Copyright (c) 2022 Martijn van Welie
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy
+ *   of this software and associated documentation files (the "Software"), to deal
+ *   in the Software without restriction, including without limitation the rights
+ *   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *   copies of the Software, and to permit persons to whom the Software is
+ *   furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included in all
+ *   copies or substantial portions of the Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *   SOFTWARE.
+ *
+ */
+
+#include "object_manager.h"
+#include "logger.h"
+
+static const char *const TAG = "ObjectManager";
+static const char *const BLUEZ_DBUS = "org.bluez";
+static const char *const INTERFACE_OBJECT_MANAGER = "org.freedesktop.DBus.ObjectManager";
+
+struct binc_object_manager_cache {
+    GDBusConnection *connection; // Borrowed
+    GHashTable *objects; // Owned, object path -> (interface name -> GVariant 'a{sv}')
+    gboolean ready;
+    GList *pending; // Owned, requests waiting for the initial GetManagedObjects
+    guint iface_added;
+    guint iface_removed;
+    int ref_count;
+};
+
+typedef struct binc_object_manager_pending {
+    ObjectManagerReadyCallback callback;
+    gpointer user_data;
+} PendingRequest;
+
+// There is one cache per process: all adapters share the same dbus connection
+static ObjectManagerCache *shared_cache = NULL;
+
+static void interface_table_value_free(GVariant *properties) { g_variant_unref(properties); }
+
+static GHashTable *interface_table_new(void) {
+    return g_hash_table_new_full(g_str_hash, g_str_equal,
+                                 g_free, (GDestroyNotify) interface_table_value_free);
+}
+
+static void binc_internal_cache_add_interfaces(ObjectManagerCache *cache, const char *object_path,
+                                               GVariant *ifaces_and_properties) {
+    GHashTable *interfaces = g_hash_table_lookup(cache->objects, object_path);
+    if (interfaces == NULL) {
+        interfaces = interface_table_new();
+        g_hash_table_insert(cache->objects, g_strdup(object_path), interfaces);
+    }
+
+    const char *interface_name;
+    GVariant *properties;
+    GVariantIter iter;
+    g_variant_iter_init(&iter, ifaces_and_properties);
+    while (g_variant_iter_loop(&iter, "{&s@a{sv}}", &interface_name, &properties)) {
+        g_hash_table_insert(interfaces, g_strdup(interface_name), g_variant_ref(properties));
+    }
+}
+
+static void binc_internal_cache_interfaces_added(__attribute__((unused)) GDBusConnection *conn,
+                                                 __attribute__((unused)) const gchar *sender_name,
+                                                 __attribute__((unused)) const gchar *object_path,
+                                                 __attribute__((unused)) const gchar *interface,
+                                                 __attribute__((unused)) const gchar *signal_name,
+                                                 GVariant *parameters,
+                                                 gpointer user_data) {
+
+    ObjectManagerCache *cache = (ObjectManagerCache *) user_data;
+    g_assert(cache != NULL);
+
+    const char *object = NULL;
+    GVariant *ifaces_and_properties = NULL;
+
+    g_assert(g_str_equal(g_variant_get_type_string(parameters), "(oa{sa{sv}})"));
+    g_variant_get(parameters, "(&o@a{sa{sv}})", &object, &ifaces_and_properties);
+    binc_internal_cache_add_interfaces(cache, object, ifaces_and_properties);
+    g_variant_unref(ifaces_and_properties);
+}
+
+static void binc_internal_cache_interfaces_removed(__attribute__((unused)) GDBusConnection *conn,
+                                                   __attribute__((unused)) const gchar *sender_name,
+                                                   __attribute__((unused)) const gchar *object_path,
+                                                   __attribute__((unused)) const gchar *interface,
+                                                   __attribute__((unused)) const gchar *signal_name,
+                                                   GVariant *parameters,
+                                                   gpointer user_data) {
+
+    ObjectManagerCache *cache = (ObjectManagerCache *) user_data;
+    g_assert(cache != NULL);
+
+    GVariantIter *interfaces = NULL;
+    const char *object = NULL;
+    const char *interface_name = NULL;
+
+    g_assert(g_str_equal(g_variant_get_type_string(parameters), "(oas)"));
+    g_variant_get(parameters, "(&oas)", &object, &interfaces);
+
+    GHashTable *interface_table = g_hash_table_lookup(cache->objects, object);
+    while (g_variant_iter_loop(interfaces, "&s", &interface_name)) {
+        if (interface_table != NULL) {
+            g_hash_table_remove(interface_table, interface_name);
+        }
+    }
+
+    if (interface_table != NULL && g_hash_table_size(interface_table) == 0) {
+        g_hash_table_remove(cache->objects, object);
+    }
+
+    if (interfaces != NULL)
+        g_variant_iter_free(interfaces);
+}
+
+static void binc_internal_cache_flush_pending(ObjectManagerCache *cache) {
+    GList *pending = cache->pending;
+    cache->pending = NULL;
+
+    for (GList *iterator = pending; iterator; iterator = iterator->next) {
+        PendingRequest *request = (PendingRequest *) iterator->data;
+        request->callback(cache, request->user_data);
+    }
+    g_list_free_full(pending, g_free);
+}
+
+static void binc_internal_cache_get_managed_objects_cb(__attribute__((unused)) GObject *source_object,
+                                                       GAsyncResult *res,
+                                                       gpointer user_data) {
+
+    ObjectManagerCache *cache = (ObjectManagerCache *) user_data;
+    g_assert(cache != NULL);
+
+    GError *error = NULL;
+    GVariant *result = g_dbus_connection_call_finish(cache->connection, res, &error);
+
+    if (result != NULL) {
+        GVariantIter *iter;
+        const char *object_path;
+        GVariant *ifaces_and_properties;
+
+        g_assert(g_str_equal(g_variant_get_type_string(result), "(a{oa{sa{sv}}})"));
+        g_variant_get(result, "(a{oa{sa{sv}}})", &iter);
+        while (g_variant_iter_loop(iter, "{&o@a{sa{sv}}}", &object_path, &ifaces_and_properties)) {
+            binc_internal_cache_add_interfaces(cache, object_path, ifaces_and_properties);
+        }
+
+        if (iter != NULL) {
+            g_variant_iter_free(iter);
+        }
+        g_variant_unref(result);
+        log_debug(TAG, "cached %d objects", g_hash_table_size(cache->objects));
+    }
+
+    if (error != NULL) {
+        log_error(TAG, "Error GetManagedObjects: %s", error->message);
+        g_clear_error(&error);
+    }
+
+    // Signal subscriptions keep the cache current from here on
+    cache->ready = TRUE;
+    binc_internal_cache_flush_pending(cache);
+}
+
+static ObjectManagerCache *binc_object_manager_cache_create(GDBusConnection *connection) {
+    ObjectManagerCache *cache = g_new0(ObjectManagerCache, 1);
+    cache->connection = connection;
+    cache->ref_count = 1;
+    cache->objects = g_hash_table_new_full(g_str_hash, g_str_equal,
+                                           g_free, (GDestroyNotify) g_hash_table_destroy);
+
+    cache->iface_added = g_dbus_connection_signal_subscribe(connection,
+                                                            BLUEZ_DBUS,
+                                                            INTERFACE_OBJECT_MANAGER,
+                                                            "InterfacesAdded",
+                                                            NULL,
+                                                            NULL,
+                                                            G_DBUS_SIGNAL_FLAGS_NONE,
+                                                            binc_internal_cache_interfaces_added,
+                                                            cache,
+                                                            NULL);
+
+    cache->iface_removed = g_dbus_connection_signal_subscribe(connection,
+                                                              BLUEZ_DBUS,
+                                                              INTERFACE_OBJECT_MANAGER,
+                                                              "InterfacesRemoved",
+                                                              NULL,
+                                                              NULL,
+                                                              G_DBUS_SIGNAL_FLAGS_NONE,
+                                                              binc_internal_cache_interfaces_removed,
+                                                              cache,
+                                                              NULL);
+
+    g_dbus_connection_call(connection,
+                           BLUEZ_DBUS,
+                           "/",
+                           INTERFACE_OBJECT_MANAGER,
+                           "GetManagedObjects",
+                           NULL,
+                           G_VARIANT_TYPE("(a{oa{sa{sv}}})"),
+                           G_DBUS_CALL_FLAGS_NONE,
+                           -1,
+                           NULL,
+                           (GAsyncReadyCallback) binc_internal_cache_get_managed_objects_cb,
+                           cache);
+    return cache;
+}
+
+ObjectManagerCache *binc_object_manager_cache_get(GDBusConnection *connection) {
+    g_assert(connection != NULL);
+
+    if (shared_cache != NULL && shared_cache->connection == connection) {
+        shared_cache->ref_count++;
+        return shared_cache;
+    }
+
+    shared_cache = binc_object_manager_cache_create(connection);
+    return shared_cache;
+}
+
+void binc_object_manager_cache_unref(ObjectManagerCache *cache) {
+    g_assert(cache != NULL);
+    g_assert(cache->ref_count > 0);
+
+    if (--cache->ref_count > 0) return;
+
+    g_dbus_connection_signal_unsubscribe(cache->connection, cache->iface_added);
+    cache->iface_added = 0;
+    g_dbus_connection_signal_unsubscribe(cache->connection, cache->iface_removed);
+    cache->iface_removed = 0;
+
+    g_hash_table_destroy(cache->objects);
+    cache->objects = NULL;
+
+    g_list_free_full(cache->pending, g_free);
+    cache->pending = NULL;
+
+    cache->connection = NULL;
+    if (shared_cache == cache) {
+        shared_cache = NULL;
+    }
+    g_free(cache);
+}
+
+void binc_object_manager_cache_when_ready(ObjectManagerCache *cache, ObjectManagerReadyCallback callback,
+                                          gpointer user_data) {
+    g_assert(cache != NULL);
+    g_assert(callback != NULL);
+
+    if (cache->ready) {
+        callback(cache, user_data);
+        return;
+    }
+
+    PendingRequest *request = g_new0(PendingRequest, 1);
+    request->callback = callback;
+    request->user_data = user_data;
+    cache->pending = g_list_append(cache->pending, request);
+}
+
+void binc_object_manager_cache_foreach(ObjectManagerCache *cache, const char *path_prefix,
+                                       ObjectManagerObjectFunc func, gpointer user_data) {
+    g_assert(cache != NULL);
+    g_assert(path_prefix != NULL);
+    g_assert(func != NULL);
+
+    GHashTableIter object_iter;
+    gpointer object_path, interface_table;
+    g_hash_table_iter_init(&object_iter, cache->objects);
+    while (g_hash_table_iter_next(&object_iter, &object_path, &interface_table)) {
+        if (!g_str_has_prefix((const char *) object_path, path_prefix)) continue;
+
+        GHashTableIter interface_iter;
+        gpointer interface_name, properties;
+        g_hash_table_iter_init(&interface_iter, (GHashTable *) interface_table);
+        while (g_hash_table_iter_next(&interface_iter, &interface_name, &properties)) {
+            func((const char *) object_path, (const char *) interface_name,
+                 (GVariant *) properties, user_data);
+        }
+    }
+}
@@ -0,0 +1,73 @@
+/*
+ *   Copyright (c) 2022 Martijn van Welie
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy
+ *   of this software and associated documentation files (the "Software"), to deal
+ *   in the Software without restriction, including without limitation the rights
+ *   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *   copies of the Software, and to permit persons to whom the Software is
+ *   furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included in all
+ *   copies or substantial portions of the Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *   SOFTWARE.
+ *
+ */
+
+#ifndef BINC_OBJECT_MANAGER_H
+#define BINC_OBJECT_MANAGER_H
+
+#include <gio/gio.h>
+#include "forward_decl.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef void (*ObjectManagerReadyCallback)(ObjectManagerCache *cache, gpointer user_data);
+
+typedef void (*ObjectManagerObjectFunc)(const char *object_path, const char *interface_name,
+                                        GVariant *properties, gpointer user_data);
+
+/**
+ * Get the shared ObjectManager cache for a dbus connection.
+ *
+ * The cache mirrors the org.bluez object tree locally: it is filled once with
+ * GetManagedObjects and kept up to date through InterfacesAdded/InterfacesRemoved,
+ * so querying it is a local lookup instead of a full-tree D-Bus round trip.
+ * The cache is shared and reference counted, release it with
+ * binc_object_manager_cache_unref().
+ *
+ * @param connection the dbus connection
+ * @return shared cache instance
+ */
+ObjectManagerCache *binc_object_manager_cache_get(GDBusConnection *connection);
+
+void binc_object_manager_cache_unref(ObjectManagerCache *cache);
+
+/**
+ * Invoke a callback once the initial GetManagedObjects result is in.
+ * If the cache is already filled, the callback is invoked immediately.
+ */
+void binc_object_manager_cache_when_ready(ObjectManagerCache *cache, ObjectManagerReadyCallback callback,
+                                          gpointer user_data);
+
+/**
+ * Call 'func' for every (object path, interface, properties) entry whose
+ * object path starts with 'path_prefix'. Iteration order is undefined.
+ */
+void binc_object_manager_cache_foreach(ObjectManagerCache *cache, const char *path_prefix,
+                                       ObjectManagerObjectFunc func, gpointer user_data);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //BINC_OBJECT_MANAGER_H
@@ -34,10 +34,9 @@ typedef enum {
     MDER_NEGATIVE_INFINITY = 0x00800002
 } ReservedFloatValues;
 
+// The heap-allocated Parser is a thin wrapper around a ParserView
 struct parser_instance {
-    const GByteArray *bytes;
-    guint offset;
-    int byteOrder;
+    ParserView view;
 };
 
 static const double reserved_float_values[5] = {MDER_POSITIVE_INFINITY, MDER_NaN, MDER_NaN, MDER_NaN,
@@ -50,111 +49,123 @@ static const double reserved_float_values[5] = {MDER_POSITIVE_INFINITY, MDER_NaN
 #define BINARY32_IMPLIED_BIT 0x800000
 #define BINARY32_SHIFT_EXPO 23
 
+void parser_view_init(ParserView *view, const GByteArray *bytes, int byteOrder) {
+    g_assert(view != NULL);
+    g_assert(bytes != NULL);
+
+    view->bytes = bytes;
+    view->offset = 0;
+    view->byteOrder = byteOrder;
+}
+
+void parser_view_set_offset(ParserView *view, guint offset) {
+    g_assert(view != NULL);
+    view->offset = offset;
+}
+
 Parser *parser_create(const GByteArray *bytes, int byteOrder) {
     Parser *parser = g_new0(Parser, 1);
-    parser->bytes = bytes;
-    parser->offset = 0;
-    parser->byteOrder = byteOrder;
+    parser_view_init(&parser->view, bytes, byteOrder);
     return parser;
 }
 
 void parser_free(Parser *parser) {
     g_assert(parser != NULL);
-    parser->bytes = NULL;
+    parser->view.bytes = NULL;
     g_free(parser);
 }
 
 void parser_set_offset(Parser *parser, guint offset) {
     g_assert(parser != NULL);
-    parser->offset = offset;
+    parser_view_set_offset(&parser->view, offset);
 }
 
-guint8 parser_get_uint8(Parser *parser) {
-    g_assert(parser != NULL);
-    g_assert(parser->offset < parser->bytes->len);
+guint8 parser_view_get_uint8(ParserView *view) {
+    g_assert(view != NULL);
+    g_assert(view->offset < view->bytes->len);
 
-    guint8 result = parser->bytes->data[parser->offset];
-    parser->offset = parser->offset + 1;
+    guint8 result = view->bytes->data[view->offset];
+    view->offset = view->offset + 1;
     return result;
 }
 
-gint8 parser_get_sint8(Parser *parser) {
-    g_assert(parser != NULL);
-    g_assert(parser->offset < parser->bytes->len);
+gint8 parser_view_get_sint8(ParserView *view) {
+    g_assert(view != NULL);
+    g_assert(view->offset < view->bytes->len);
 
-    gint8 result = (gint8) parser->bytes->data[parser->offset];
-    parser->offset = parser->offset + 1;
+    gint8 result = (gint8) view->bytes->data[view->offset];
+    view->offset = view->offset + 1;
     return result;
 }
 
-guint16 parser_get_uint16(Parser *parser) {
-    g_assert(parser != NULL);
-    g_assert((parser->offset + 1) < parser->bytes->len);
+guint16 parser_view_get_uint16(ParserView *view) {
+    g_assert(view != NULL);
+    g_assert((view->offset + 1) < view->bytes->len);
 
     guint8 byte1, byte2;
-    byte1 = parser->bytes->data[parser->offset];
-    byte2 = parser->bytes->data[parser->offset + 1];
-    parser->offset = parser->offset + 2;
-    if (parser->byteOrder == LITTLE_ENDIAN) {
+    byte1 = view->bytes->data[view->offset];
+    byte2 = view->bytes->data[view->offset + 1];
+    view->offset = view->offset + 2;
+    if (view->byteOrder == LITTLE_ENDIAN) {
         return (guint16) ((byte2 << 8) + byte1);
     } else {
         return (guint16) ((byte1 << 8) + byte2);
     }
 }
 
-gint16 parser_get_sint16(Parser *parser) {
-    g_assert(parser != NULL);
-    g_assert((parser->offset + 1) < parser->bytes->len);
+gint16 parser_view_get_sint16(ParserView *view) {
+    g_assert(view != NULL);
+    g_assert((view->offset + 1) < view->bytes->len);
 
     guint8 byte1, byte2;
-    byte1 = parser->bytes->data[parser->offset];
-    byte2 = parser->bytes->data[parser->offset + 1];
-    parser->offset = parser->offset + 2;
-    if (parser->byteOrder == LITTLE_ENDIAN) {
+    byte1 = view->bytes->data[view->offset];
+    byte2 = view->bytes->data[view->offset + 1];
+    view->offset = view->offset + 2;
+    if (view->byteOrder == LITTLE_ENDIAN) {
         return (gint16) ((byte2 << 8) + byte1);
     } else {
         return (gint16) ((byte1 << 8) + byte2);
     }
 }
 
-guint32 parser_get_uint24(Parser *parser) {
-    g_assert(parser != NULL);
-    g_assert((parser->offset + 2) < parser->bytes->len);
+guint32 parser_view_get_uint24(ParserView *view) {
+    g_assert(view != NULL);
+    g_assert((view->offset + 2) < view->bytes->len);
 
     guint8 byte1, byte2, byte3;
-    byte1 = parser->bytes->data[parser->offset];
-    byte2 = parser->bytes->data[parser->offset+1];
-    byte3 = parser->bytes->data[parser->offset+2];
-    parser->offset = parser->offset + 3;
-    if (parser->byteOrder == LITTLE_ENDIAN) {
+    byte1 = view->bytes->data[view->offset];
+    byte2 = view->bytes->data[view->offset + 1];
+    byte3 = view->bytes->data[view->offset + 2];
+    view->offset = view->offset + 3;
+    if (view->byteOrder == LITTLE_ENDIAN) {
         return (guint32) ((byte3 << 16) + (byte2 << 8) + byte1);
     } else {
         return (guint32) ((byte1 << 16) + (byte2 << 8) + byte3);
     }
 }
 
-guint32 parser_get_uint32(Parser *parser) {
-    g_assert(parser != NULL);
-    g_assert((parser->offset + 3) < parser->bytes->len);
+guint32 parser_view_get_uint32(ParserView *view) {
+    g_assert(view != NULL);
+    g_assert((view->offset + 3) < view->bytes->len);
 
     guint8 byte1, byte2, byte3, byte4;
-    byte1 = parser->bytes->data[parser->offset];
-    byte2 = parser->bytes->data[parser->offset + 1];
-    byte3 = parser->bytes->data[parser->offset + 2];
-    byte4 = parser->bytes->data[parser->offset + 3];
-    parser->offset = parser->offset + 4;
-    if (parser->byteOrder == LITTLE_ENDIAN) {
+    byte1 = view->bytes->data[view->offset];
+    byte2 = view->bytes->data[view->offset + 1];
+    byte3 = view->bytes->data[view->offset + 2];
+    byte4 = view->bytes->data[view->offset + 3];
+    view->offset = view->offset + 4;
+    if (view->byteOrder == LITTLE_ENDIAN) {
         return (guint32) ((byte4 << 24) + (byte3 << 16) + (byte2 << 8) + byte1);
     } else {
         return (guint32) ((byte1 << 24) + (byte2 << 16) + (byte3 << 8) + byte4);
     }
 }
 
-double parser_get_sfloat(Parser *parser) {
-    g_assert(parser != NULL);
-    g_assert(parser->offset < parser->bytes->len);
+double parser_view_get_sfloat(ParserView *view) {
+    g_assert(view != NULL);
+    g_assert(view->offset < view->bytes->len);
 
-    guint16 sfloat = parser_get_uint16(parser);
+    guint16 sfloat = parser_view_get_uint16(view);
 
     int mantissa = sfloat & 0xfff;
     if (mantissa >= 0x800) {
@@ -174,9 +185,9 @@ float fround(float n, int d) {
     return (float) rounded / (float) divider;
 }
 
-double parser_get_float(Parser *parser) {
-    g_assert(parser != NULL);
-    guint32 int_data = parser_get_uint32(parser);
+double parser_view_get_float(ParserView *view) {
+    g_assert(view != NULL);
+    guint32 int_data = parser_view_get_uint32(view);
 
     guint32 mantissa = int_data & 0xFFFFFF;
     gint8 exponent = (gint8) (int_data >> 24);
@@ -195,9 +206,9 @@ double parser_get_float(Parser *parser) {
     return output;
 }
 
-double parser_get_754float(Parser *parser) {
-    g_assert(parser != NULL);
-    guint32 int_data = parser_get_uint32(parser);
+double parser_view_get_754float(ParserView *view) {
+    g_assert(view != NULL);
+    guint32 int_data = parser_view_get_uint32(view);
 
     // Break up into 3 parts
     gboolean sign = (gboolean) (int_data & BINARY32_MASK_SIGN);
@@ -207,63 +218,326 @@ double parser_get_754float(Parser *parser) {
     float result;
     if (biased_expo == 0xFF) {
         result = significand ? NAN : INFINITY;   // For simplicity, NaN payload not copied
-    }   
+    }
     else {
         guint32 expo;
 
         if (biased_expo > 0) {
             significand |= BINARY32_IMPLIED_BIT;
             expo = biased_expo - 127;
-        }   
+        }
         else {
             expo = 126;
-        }   
+        }
 
         result = ldexpf((float)significand, (int) (expo - BINARY32_SHIFT_EXPO));
-    }   
+    }
 
-    if (sign) result = -result; 
+    if (sign) result = -result;
 
     return result;
 }
 
-double parser_get_754half(Parser *parser) {
-    g_assert(parser != NULL);
-    g_assert(parser->offset < parser->bytes->len);
+double parser_view_get_754half(ParserView *view) {
+    g_assert(view != NULL);
+    g_assert(view->offset < view->bytes->len);
 
-    guint16 value = parser_get_uint16(parser);
+    guint16 value = parser_view_get_uint16(view);
 
     gboolean sign = ((value & 0x8000) != 0);
-	guint16 exponent = (value & 0x7c00) >> 10;
-	guint16 fraction = value & 0x300;
-	
-	float result = 0.0;
-
-	if (exponent == 0) {
-		if (fraction == 0) {
-			return (0.0);
-		}
-		else {
-			result = (float) (pow(-1, sign) * pow(2, -14) * ((float) fraction / 1024));
-		}
-	}
-	else if (exponent == 0x1f) {
-		if (fraction == 0) return (INFINITY);
-		else return (NAN);
-	}
-	else {
-		result = (float) (pow(-1, sign) * pow(2, exponent - 15) * (1.0 + (float) fraction / 1024));
-	}
-	
-	return (result);
+    guint16 exponent = (value & 0x7c00) >> 10;
+    guint16 fraction = value & 0x300;
+
+    float result = 0.0;
+
+    if (exponent == 0) {
+        if (fraction == 0) {
+            return (0.0);
+        }
+        else {
+            result = (float) (pow(-1, sign) * pow(2, -14) * ((float) fraction / 1024));
+        }
+    }
+    else if (exponent == 0x1f) {
+        if (fraction == 0) return (INFINITY);
+        else return (NAN);
+    }
+    else {
+        result = (float) (pow(-1, sign) * pow(2, exponent - 15) * (1.0 + (float) fraction / 1024));
+    }
+
+    return (result);
+}
+
+gsize parser_view_get_string(ParserView *view, char *buffer, gsize buffer_size) {
+    g_assert(view != NULL);
+    g_assert(view->bytes != NULL);
+    g_assert(buffer != NULL);
+    g_assert(buffer_size > 0);
+
+    gsize remaining = view->bytes->len - view->offset;
+    gsize length = MIN(remaining, buffer_size - 1);
+    memcpy(buffer, view->bytes->data + view->offset, length);
+    buffer[length] = 0;
+    return length;
+}
+
+static guint parser_field_size(ParserFieldType type) {
+    switch (type) {
+        case PARSER_FIELD_UINT8:
+        case PARSER_FIELD_SINT8:
+            return 1;
+        case PARSER_FIELD_UINT16:
+        case PARSER_FIELD_SINT16:
+        case PARSER_FIELD_SFLOAT:
+            return 2;
+        case PARSER_FIELD_UINT24:
+            return 3;
+        case PARSER_FIELD_UINT32:
+        case PARSER_FIELD_FLOAT:
+            return 4;
+        default:
+            g_assert_not_reached();
+    }
+}
+
+gboolean parser_view_extract(ParserView *view, const ParserField *fields, guint field_count) {
+    g_assert(view != NULL);
+    g_assert(fields != NULL);
+
+    // Check the total length up front so extraction is all-or-nothing
+    guint needed = 0;
+    for (guint i = 0; i < field_count; i++) {
+        needed += parser_field_size(fields[i].type);
+    }
+    if (view->offset + needed > view->bytes->len) return FALSE;
+
+    for (guint i = 0; i < field_count; i++) {
+        switch (fields[i].type) {
+            case PARSER_FIELD_UINT8:
+                *((guint8 *) fields[i].destination) = parser_view_get_uint8(view);
+                break;
+            case PARSER_FIELD_SINT8:
+                *((gint8 *) fields[i].destination) = parser_view_get_sint8(view);
+                break;
+            case PARSER_FIELD_UINT16:
+                *((guint16 *) fields[i].destination) = parser_view_get_uint16(view);
+                break;
+            case PARSER_FIELD_SINT16:
+                *((gint16 *) fields[i].destination) = parser_view_get_sint16(view);
+                break;
+            case PARSER_FIELD_UINT24:
+                *((guint32 *) fields[i].destination) = parser_view_get_uint24(view);
+                break;
+            case PARSER_FIELD_UINT32:
+                *((guint32 *) fields[i].destination) = parser_view_get_uint32(view);
+                break;
+            case PARSER_FIELD_SFLOAT:
+                *((double *) fields[i].destination) = parser_view_get_sfloat(view);
+                break;
+            case PARSER_FIELD_FLOAT:
+                *((double *) fields[i].destination) = parser_view_get_float(view);
+                break;
+            default:
+                g_assert_not_reached();
+        }
+    }
+    return TRUE;
+}
+
+void packer_init(Packer *packer, guint8 *buffer, gsize capacity, int byteOrder) {
+    g_assert(packer != NULL);
+    g_assert(buffer != NULL);
+    g_assert(capacity > 0);
+
+    packer->buffer = buffer;
+    packer->capacity = capacity;
+    packer->offset = 0;
+    packer->byteOrder = byteOrder;
+}
+
+gsize packer_get_length(const Packer *packer) {
+    g_assert(packer != NULL);
+    return packer->offset;
+}
+
+void packer_reset(Packer *packer) {
+    g_assert(packer != NULL);
+    packer->offset = 0;
+}
+
+gboolean packer_put_uint8(Packer *packer, guint8 value) {
+    g_assert(packer != NULL);
+
+    if (packer->offset + 1 > packer->capacity) return FALSE;
+    packer->buffer[packer->offset] = value;
+    packer->offset = packer->offset + 1;
+    return TRUE;
+}
+
+gboolean packer_put_sint8(Packer *packer, gint8 value) {
+    return packer_put_uint8(packer, (guint8) value);
+}
+
+gboolean packer_put_uint16(Packer *packer, guint16 value) {
+    g_assert(packer != NULL);
+
+    if (packer->offset + 2 > packer->capacity) return FALSE;
+    guint8 lsb = (guint8) (value & 0xFF);
+    guint8 msb = (guint8) (value >> 8);
+    if (packer->byteOrder == LITTLE_ENDIAN) {
+        packer->buffer[packer->offset] = lsb;
+        packer->buffer[packer->offset + 1] = msb;
+    } else {
+        packer->buffer[packer->offset] = msb;
+        packer->buffer[packer->offset + 1] = lsb;
+    }
+    packer->offset = packer->offset + 2;
+    return TRUE;
+}
+
+gboolean packer_put_sint16(Packer *packer, gint16 value) {
+    return packer_put_uint16(packer, (guint16) value);
+}
+
+gboolean packer_put_uint24(Packer *packer, guint32 value) {
+    g_assert(packer != NULL);
+
+    if (value > 0xFFFFFF) return FALSE;
+    if (packer->offset + 3 > packer->capacity) return FALSE;
+    guint8 byte1 = (guint8) (value & 0xFF);
+    guint8 byte2 = (guint8) ((value >> 8) & 0xFF);
+    guint8 byte3 = (guint8) (value >> 16);
+    if (packer->byteOrder == LITTLE_ENDIAN) {
+        packer->buffer[packer->offset] = byte1;
+        packer->buffer[packer->offset + 1] = byte2;
+        packer->buffer[packer->offset + 2] = byte3;
+    } else {
+        packer->buffer[packer->offset] = byte3;
+        packer->buffer[packer->offset + 1] = byte2;
+        packer->buffer[packer->offset + 2] = byte1;
+    }
+    packer->offset = packer->offset + 3;
+    return TRUE;
+}
+
+gboolean packer_put_uint32(Packer *packer, guint32 value) {
+    g_assert(packer != NULL);
+
+    if (packer->offset + 4 > packer->capacity) return FALSE;
+    guint8 byte1 = (guint8) (value & 0xFF);
+    guint8 byte2 = (guint8) ((value >> 8) & 0xFF);
+    guint8 byte3 = (guint8) ((value >> 16) & 0xFF);
+    guint8 byte4 = (guint8) (value >> 24);
+    if (packer->byteOrder == LITTLE_ENDIAN) {
+        packer->buffer[packer->offset] = byte1;
+        packer->buffer[packer->offset + 1] = byte2;
+        packer->buffer[packer->offset + 2] = byte3;
+        packer->buffer[packer->offset + 3] = byte4;
+    } else {
+        packer->buffer[packer->offset] = byte4;
+        packer->buffer[packer->offset + 1] = byte3;
+        packer->buffer[packer->offset + 2] = byte2;
+        packer->buffer[packer->offset + 3] = byte1;
+    }
+    packer->offset = packer->offset + 4;
+    return TRUE;
+}
+
+gboolean packer_put_sfloat(Packer *packer, double value, gint8 exponent) {
+    g_assert(packer != NULL);
+
+    long mantissa = lround(value / pow(10.0, exponent));
+    if (mantissa < -2048 || mantissa > 2047) return FALSE;
+
+    guint16 sfloat = (guint16) (((guint16) ((guint8) exponent & 0x0F) << 12) | ((guint16) mantissa & 0x0FFF));
+    return packer_put_uint16(packer, sfloat);
+}
+
+gboolean packer_put_float(Packer *packer, double value, gint8 exponent) {
+    g_assert(packer != NULL);
+
+    long mantissa = lround(value / pow(10.0, exponent));
+    if (mantissa < -8388608 || mantissa > 8388607) return FALSE;
+
+    guint32 mder_float = ((guint32) (guint8) exponent << 24) | ((guint32) mantissa & 0xFFFFFF);
+    return packer_put_uint32(packer, mder_float);
+}
+
+gboolean packer_put_754float(Packer *packer, float value) {
+    g_assert(packer != NULL);
+
+    guint32 bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return packer_put_uint32(packer, bits);
+}
+
+gboolean packer_put_bytes(Packer *packer, const guint8 *data, gsize length) {
+    g_assert(packer != NULL);
+    g_assert(data != NULL);
+
+    if (packer->offset + length > packer->capacity) return FALSE;
+    memcpy(packer->buffer + packer->offset, data, length);
+    packer->offset = packer->offset + length;
+    return TRUE;
+}
+
+guint8 parser_get_uint8(Parser *parser) {
+    g_assert(parser != NULL);
+    return parser_view_get_uint8(&parser->view);
+}
+
+gint8 parser_get_sint8(Parser *parser) {
+    g_assert(parser != NULL);
+    return parser_view_get_sint8(&parser->view);
+}
+
+guint16 parser_get_uint16(Parser *parser) {
+    g_assert(parser != NULL);
+    return parser_view_get_uint16(&parser->view);
+}
+
+gint16 parser_get_sint16(Parser *parser) {
+    g_assert(parser != NULL);
+    return parser_view_get_sint16(&parser->view);
+}
+
+guint32 parser_get_uint24(Parser *parser) {
+    g_assert(parser != NULL);
+    return parser_view_get_uint24(&parser->view);
+}
+
+guint32 parser_get_uint32(Parser *parser) {
+    g_assert(parser != NULL);
+    return parser_view_get_uint32(&parser->view);
+}
+
+double parser_get_sfloat(Parser *parser) {
+    g_assert(parser != NULL);
+    return parser_view_get_sfloat(&parser->view);
+}
+
+double parser_get_float(Parser *parser) {
+    g_assert(parser != NULL);
+    return parser_view_get_float(&parser->view);
+}
+
+double parser_get_754float(Parser *parser) {
+    g_assert(parser != NULL);
+    return parser_view_get_754float(&parser->view);
+}
+
+double parser_get_754half(Parser *parser) {
+    g_assert(parser != NULL);
+    return parser_view_get_754half(&parser->view);
 }
 
 GString *parser_get_string(Parser *parser) {
     g_assert(parser != NULL);
-    g_assert(parser->bytes != NULL);
+    g_assert(parser->view.bytes != NULL);
 
-    return g_string_new_len((const char *) parser->bytes->data + parser->offset,
-                            (gssize) (parser->bytes->len - parser->offset));
+    return g_string_new_len((const char *) parser->view.bytes->data + parser->view.offset,
+                            (gssize) (parser->view.bytes->len - parser->view.offset));
 }
 
 GDateTime *parser_get_date_time(Parser *parser) {
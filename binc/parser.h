@@ -33,6 +33,38 @@ extern "C" {
 
 typedef struct parser_instance Parser;
 
+/*
+ * Stack/value based variant of the Parser: the struct is owned by the caller
+ * so decoding a value performs no heap allocation at all. Initialize with
+ * parser_view_init() and use the parser_view_get_* accessors; no free needed.
+ */
+typedef struct parser_view {
+    const GByteArray *bytes;
+    guint offset;
+    int byteOrder;
+} ParserView;
+
+typedef enum ParserFieldType {
+    PARSER_FIELD_UINT8,
+    PARSER_FIELD_SINT8,
+    PARSER_FIELD_UINT16,
+    PARSER_FIELD_SINT16,
+    PARSER_FIELD_UINT24,
+    PARSER_FIELD_UINT32,
+    PARSER_FIELD_SFLOAT,
+    PARSER_FIELD_FLOAT
+} ParserFieldType;
+
+/*
+ * One field of a bulk extraction. 'destination' must point to a guint8/gint8
+ * for the 8-bit types, guint16/gint16 for the 16-bit types, guint32 for
+ * uint24/uint32 and a double for sfloat/float.
+ */
+typedef struct parser_field {
+    ParserFieldType type;
+    void *destination;
+} ParserField;
+
 /**
  * Create a parser for a byte array
  *
@@ -74,6 +106,115 @@ GByteArray *binc_get_current_time(void);
 
 GString *parser_get_string(Parser *parser);
 
+/**
+ * Initialize a caller-owned ParserView for a byte array
+ *
+ * @param view the view to initialize
+ * @param bytes the byte array
+ * @param byteOrder either LITTLE_ENDIAN or BIG_ENDIAN
+ */
+void parser_view_init(ParserView *view, const GByteArray *bytes, int byteOrder);
+
+void parser_view_set_offset(ParserView *view, guint offset);
+
+guint8 parser_view_get_uint8(ParserView *view);
+
+gint8 parser_view_get_sint8(ParserView *view);
+
+guint16 parser_view_get_uint16(ParserView *view);
+
+gint16 parser_view_get_sint16(ParserView *view);
+
+guint32 parser_view_get_uint24(ParserView *view);
+
+guint32 parser_view_get_uint32(ParserView *view);
+
+double parser_view_get_sfloat(ParserView *view);
+
+double parser_view_get_float(ParserView *view);
+
+double parser_view_get_754half(ParserView *view);
+
+double parser_view_get_754float(ParserView *view);
+
+/**
+ * Copy the remaining bytes into a caller-provided buffer as a NUL terminated
+ * string, truncating if the buffer is too small.
+ *
+ * @return the number of bytes copied, not counting the NUL terminator
+ */
+gsize parser_view_get_string(ParserView *view, char *buffer, gsize buffer_size);
+
+/**
+ * Extract a list of fields in one pass into caller-provided destinations.
+ *
+ * @return TRUE if all fields fit in the remaining bytes, FALSE otherwise (nothing is extracted)
+ */
+gboolean parser_view_extract(ParserView *view, const ParserField *fields, guint field_count);
+
+/*
+ * Write-side counterpart to the ParserView: packs values into a caller
+ * provided fixed buffer, so building an outgoing payload performs no heap
+ * allocation at all. Initialize with packer_init() and use the packer_put_*
+ * functions, which return FALSE when the value does not fit; no free needed.
+ */
+typedef struct packer_instance {
+    guint8 *buffer;
+    gsize capacity;
+    gsize offset;
+    int byteOrder;
+} Packer;
+
+/**
+ * Initialize a caller-owned Packer for a fixed buffer
+ *
+ * @param packer the packer to initialize
+ * @param buffer the buffer to pack into
+ * @param capacity size of the buffer in bytes
+ * @param byteOrder either LITTLE_ENDIAN or BIG_ENDIAN
+ */
+void packer_init(Packer *packer, guint8 *buffer, gsize capacity, int byteOrder);
+
+/**
+ * Get the number of bytes packed so far
+ */
+gsize packer_get_length(const Packer *packer);
+
+/**
+ * Rewind the packer so the buffer can be reused for the next payload
+ */
+void packer_reset(Packer *packer);
+
+gboolean packer_put_uint8(Packer *packer, guint8 value);
+
+gboolean packer_put_sint8(Packer *packer, gint8 value);
+
+gboolean packer_put_uint16(Packer *packer, guint16 value);
+
+gboolean packer_put_sint16(Packer *packer, gint16 value);
+
+gboolean packer_put_uint24(Packer *packer, guint32 value);
+
+gboolean packer_put_uint32(Packer *packer, guint32 value);
+
+/**
+ * Pack a value as an IEEE 11073 16-bit SFLOAT with the given base-10 exponent.
+ * The stored mantissa is round(value / 10^exponent) and must fit in 12 bits;
+ * returns FALSE when it does not, or when the buffer is full.
+ */
+gboolean packer_put_sfloat(Packer *packer, double value, gint8 exponent);
+
+/**
+ * Pack a value as an IEEE 11073 32-bit FLOAT with the given base-10 exponent.
+ * The stored mantissa is round(value / 10^exponent) and must fit in 24 bits;
+ * returns FALSE when it does not, or when the buffer is full.
+ */
+gboolean packer_put_float(Packer *packer, double value, gint8 exponent);
+
+gboolean packer_put_754float(Packer *packer, float value);
+
+gboolean packer_put_bytes(Packer *packer, const guint8 *data, gsize length);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,202 @@
+/*
+ *   Copyright (c) 2022 Martijn van Welie
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy
+ *   of this software and associated documentation files (the "Software"), to deal
+ *   in the Software without restriction, including without limitation the rights
+ *   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *   copies of the Software, and to permit persons to whom the Software is
+ *   furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included in all
+ *   copies or substantial portions of the Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *   SOFTWARE.
+ *
+ */
+
+#include "scan_coordinator.h"
+#include "adapter.h"
+#include "device.h"
+#include "logger.h"
+#include "utility.h"
+
+static const char *const TAG = "ScanCoordinator";
+
+struct binc_scan_coordinator {
+    GPtrArray *adapters; // Borrowed, adapters are borrowed
+    ScanResultCallback resultCallback;
+    GHashTable *seen_devices; // Owned, address -> SeenDevice
+    guint stagger_window_ms;
+    guint stagger_timer;
+    guint active_adapter_index;
+    gboolean running;
+    void *user_data; // Borrowed
+};
+
+typedef struct {
+    GHashTable *rssi_by_adapter; // Owned, adapter path -> RSSI
+} SeenDevice;
+
+// Maps Adapter -> ScanCoordinator so the shared discovery callback can find
+// its coordinator again. Only touched from the GMainLoop thread.
+static GHashTable *coordinators_by_adapter = NULL;
+
+static void binc_internal_seen_device_free(SeenDevice *seen) {
+    g_hash_table_destroy(seen->rssi_by_adapter);
+    g_free(seen);
+}
+
+static void binc_internal_coordinator_discovery_result(Adapter *adapter, Device *device) {
+    ScanCoordinator *coordinator = g_hash_table_lookup(coordinators_by_adapter, adapter);
+    if (coordinator == NULL) return;
+
+    const char *address = binc_device_get_address(device);
+    SeenDevice *seen = g_hash_table_lookup(coordinator->seen_devices, address);
+    if (seen == NULL) {
+        seen = g_new0(SeenDevice, 1);
+        seen->rssi_by_adapter = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
+        g_hash_table_insert(coordinator->seen_devices, g_strdup(address), seen);
+    }
+
+    g_hash_table_insert(seen->rssi_by_adapter, g_strdup(binc_adapter_get_path(adapter)),
+                        GINT_TO_POINTER((gint) binc_device_get_rssi(device)));
+
+    // Deliver the sighting adapter's own Device. Results are merged by address
+    // only; caching a Device here would dangle once bluetoothd removes it
+    if (coordinator->resultCallback != NULL) {
+        coordinator->resultCallback(coordinator, adapter, device);
+    }
+}
+
+ScanCoordinator *binc_scan_coordinator_create(GPtrArray *adapters) {
+    g_assert(adapters != NULL);
+    g_assert(adapters->len > 0);
+
+    ScanCoordinator *coordinator = g_new0(ScanCoordinator, 1);
+    coordinator->adapters = adapters;
+    coordinator->seen_devices = g_hash_table_new_full(g_str_hash, g_str_equal, g_free,
+                                                      (GDestroyNotify) binc_internal_seen_device_free);
+
+    if (coordinators_by_adapter == NULL) {
+        coordinators_by_adapter = g_hash_table_new(g_direct_hash, g_direct_equal);
+    }
+    return coordinator;
+}
+
+void binc_scan_coordinator_free(ScanCoordinator *coordinator) {
+    g_assert(coordinator != NULL);
+
+    binc_scan_coordinator_stop(coordinator);
+
+    g_hash_table_destroy(coordinator->seen_devices);
+    coordinator->seen_devices = NULL;
+    coordinator->adapters = NULL;
+    g_free(coordinator);
+}
+
+void binc_scan_coordinator_set_result_cb(ScanCoordinator *coordinator, ScanResultCallback callback) {
+    g_assert(coordinator != NULL);
+    g_assert(callback != NULL);
+    coordinator->resultCallback = callback;
+}
+
+void binc_scan_coordinator_set_stagger(ScanCoordinator *coordinator, guint window_ms) {
+    g_assert(coordinator != NULL);
+    g_assert(!coordinator->running);
+    coordinator->stagger_window_ms = window_ms;
+}
+
+static gboolean binc_internal_stagger_timer(gpointer user_data) {
+    ScanCoordinator *coordinator = (ScanCoordinator *) user_data;
+    g_assert(coordinator != NULL);
+
+    Adapter *previous = g_ptr_array_index(coordinator->adapters, coordinator->active_adapter_index);
+    binc_adapter_stop_discovery(previous);
+
+    coordinator->active_adapter_index = (coordinator->active_adapter_index + 1) % coordinator->adapters->len;
+    Adapter *next = g_ptr_array_index(coordinator->adapters, coordinator->active_adapter_index);
+    binc_adapter_start_discovery(next);
+    return TRUE;
+}
+
+void binc_scan_coordinator_start(ScanCoordinator *coordinator) {
+    g_assert(coordinator != NULL);
+
+    if (coordinator->running) return;
+    coordinator->running = TRUE;
+
+    for (guint i = 0; i < coordinator->adapters->len; i++) {
+        Adapter *adapter = g_ptr_array_index(coordinator->adapters, i);
+        g_hash_table_insert(coordinators_by_adapter, adapter, coordinator);
+        binc_adapter_set_discovery_cb(adapter, binc_internal_coordinator_discovery_result);
+    }
+
+    if (coordinator->stagger_window_ms > 0 && coordinator->adapters->len > 1) {
+        coordinator->active_adapter_index = 0;
+        binc_adapter_start_discovery(g_ptr_array_index(coordinator->adapters, 0));
+        coordinator->stagger_timer = binc_timeout_add(coordinator->stagger_window_ms,
+                                                   binc_internal_stagger_timer, coordinator);
+        log_debug(TAG, "started staggered discovery on %d adapters (window %dms)",
+                  coordinator->adapters->len, coordinator->stagger_window_ms);
+    } else {
+        for (guint i = 0; i < coordinator->adapters->len; i++) {
+            binc_adapter_start_discovery(g_ptr_array_index(coordinator->adapters, i));
+        }
+        log_debug(TAG, "started discovery on %d adapters", coordinator->adapters->len);
+    }
+}
+
+void binc_scan_coordinator_stop(ScanCoordinator *coordinator) {
+    g_assert(coordinator != NULL);
+
+    if (!coordinator->running) return;
+    coordinator->running = FALSE;
+
+    if (coordinator->stagger_timer != 0) {
+        binc_source_remove(coordinator->stagger_timer);
+        coordinator->stagger_timer = 0;
+    }
+
+    for (guint i = 0; i < coordinator->adapters->len; i++) {
+        Adapter *adapter = g_ptr_array_index(coordinator->adapters, i);
+        binc_adapter_stop_discovery(adapter);
+        binc_adapter_set_discovery_cb(adapter, NULL);
+        g_hash_table_remove(coordinators_by_adapter, adapter);
+    }
+}
+
+gboolean binc_scan_coordinator_get_rssi(const ScanCoordinator *coordinator, const char *address,
+                                        const Adapter *adapter, short *rssi) {
+    g_assert(coordinator != NULL);
+    g_assert(address != NULL);
+    g_assert(adapter != NULL);
+    g_assert(rssi != NULL);
+
+    SeenDevice *seen = g_hash_table_lookup(coordinator->seen_devices, address);
+    if (seen == NULL) return FALSE;
+
+    gpointer value = NULL;
+    if (!g_hash_table_lookup_extended(seen->rssi_by_adapter, binc_adapter_get_path(adapter), NULL, &value)) {
+        return FALSE;
+    }
+
+    *rssi = (short) GPOINTER_TO_INT(value);
+    return TRUE;
+}
+
+void binc_scan_coordinator_set_user_data(ScanCoordinator *coordinator, void *user_data) {
+    g_assert(coordinator != NULL);
+    coordinator->user_data = user_data;
+}
+
+void *binc_scan_coordinator_get_user_data(const ScanCoordinator *coordinator) {
+    g_assert(coordinator != NULL);
+    return coordinator->user_data;
+}
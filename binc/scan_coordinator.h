@@ -0,0 +1,97 @@
+/*
+ *   Copyright (c) 2022 Martijn van Welie
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy
+ *   of this software and associated documentation files (the "Software"), to deal
+ *   in the Software without restriction, including without limitation the rights
+ *   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *   copies of the Software, and to permit persons to whom the Software is
+ *   furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included in all
+ *   copies or substantial portions of the Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *   SOFTWARE.
+ *
+ */
+
+#ifndef BINC_SCAN_COORDINATOR_H
+#define BINC_SCAN_COORDINATOR_H
+
+#include <glib.h>
+#include "forward_decl.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Called for every discovery result from any of the coordinated adapters.
+ *
+ * 'adapter' is the adapter that produced this particular sighting and
+ * 'device' is that adapter's own Device object, so the same peripheral is
+ * delivered through a different Device per adapter. Match sightings by
+ * binc_device_get_address() and use binc_scan_coordinator_get_rssi() for
+ * the per-adapter RSSI.
+ */
+typedef void (*ScanResultCallback)(ScanCoordinator *coordinator, Adapter *adapter, Device *device);
+
+/**
+ * Create a scan coordinator for a set of adapters.
+ *
+ * The coordinator takes over the discovery callbacks of the given adapters
+ * while it runs; results from all adapters are merged by device address into
+ * a single callback stream.
+ *
+ * @param adapters adapters to coordinate (borrowed, must outlive the coordinator)
+ * @return the coordinator, free with binc_scan_coordinator_free()
+ */
+ScanCoordinator *binc_scan_coordinator_create(GPtrArray *adapters);
+
+void binc_scan_coordinator_free(ScanCoordinator *coordinator);
+
+void binc_scan_coordinator_set_result_cb(ScanCoordinator *coordinator, ScanResultCallback callback);
+
+/**
+ * Stagger scan windows across the adapters.
+ *
+ * When set, only one adapter scans at a time and the active adapter advances
+ * every 'window_ms', so the radios do not compete for the same advertising
+ * channels. Pass 0 (the default) to let all adapters scan continuously.
+ *
+ * @param coordinator the coordinator
+ * @param window_ms scan window per adapter in milliseconds, 0 to disable staggering
+ */
+void binc_scan_coordinator_set_stagger(ScanCoordinator *coordinator, guint window_ms);
+
+void binc_scan_coordinator_start(ScanCoordinator *coordinator);
+
+void binc_scan_coordinator_stop(ScanCoordinator *coordinator);
+
+/**
+ * Get the last RSSI a specific adapter reported for an address.
+ *
+ * @param coordinator the coordinator
+ * @param address the device address
+ * @param adapter the adapter the RSSI was measured on
+ * @param rssi receives the RSSI in dBm
+ * @return TRUE if this adapter has seen the address, FALSE otherwise
+ */
+gboolean binc_scan_coordinator_get_rssi(const ScanCoordinator *coordinator, const char *address,
+                                        const Adapter *adapter, short *rssi);
+
+void binc_scan_coordinator_set_user_data(ScanCoordinator *coordinator, void *user_data);
+
+void *binc_scan_coordinator_get_user_data(const ScanCoordinator *coordinator);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //BINC_SCAN_COORDINATOR_H
@@ -24,11 +24,12 @@
 #include "service.h"
 #include "characteristic.h"
 #include "utility.h"
+#include "uuid.h"
 
 struct binc_service {
     Device *device; // Borrowed
     const char *path; // Owned
-    const char* uuid; // Owned
+    const char* uuid; // Interned
     GList *characteristics; // Owned
 };
 
@@ -40,7 +41,7 @@ Service* binc_service_create(Device *device, const char* path, const char* uuid)
     Service *service = g_new0(Service, 1);
     service->device = device;
     service->path = g_strdup(path);
-    service->uuid = g_strdup(uuid);
+    service->uuid = binc_uuid_intern_string(uuid);
     service->characteristics = NULL;
     return service;
 }
@@ -51,7 +52,6 @@ void binc_service_free(Service *service) {
     g_free((char*) service->path);
     service->path = NULL;
 
-    g_free((char*) service->uuid);
     service->uuid = NULL;
 
     g_list_free(service->characteristics);
@@ -89,9 +89,11 @@ Characteristic *binc_service_get_characteristic(const Service *service, const ch
     g_assert(is_valid_uuid(char_uuid));
 
     if (service->characteristics != NULL) {
+        // Characteristic uuids are interned, so one interning and pointer compares will do
+        const char *interned_uuid = binc_uuid_intern_string(char_uuid);
         for (GList *iterator = service->characteristics; iterator; iterator = iterator->next) {
             Characteristic *characteristic = (Characteristic *) iterator->data;
-            if (g_str_equal(char_uuid, binc_characteristic_get_uuid(characteristic))) {
+            if (interned_uuid == binc_characteristic_get_uuid(characteristic)) {
                 return characteristic;
             }
         }
@@ -0,0 +1,78 @@
+/*
+ *   Copyright (c) 2022 Martijn van Welie
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy
+ *   of this software and associated documentation files (the "Software"), to deal
+ *   in the Software without restriction, including without limitation the rights
+ *   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *   copies of the Software, and to permit persons to whom the Software is
+ *   furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included in all
+ *   copies or substantial portions of the Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *   SOFTWARE.
+ *
+ */
+
+#include "stats.h"
+
+static gint stats_enabled = 0;
+static gint counters[BINC_STATS_COUNTER_COUNT];
+static gint latency_buckets[BINC_STATS_LATENCY_BUCKET_COUNT];
+
+static const gint64 latency_upper_bounds_ms[BINC_STATS_LATENCY_BUCKET_COUNT - 1] = {1, 2, 5, 10, 20, 50, 100};
+
+void binc_stats_set_enabled(gboolean enabled) {
+    g_atomic_int_set(&stats_enabled, enabled ? 1 : 0);
+}
+
+gboolean binc_stats_is_enabled(void) {
+    return g_atomic_int_get(&stats_enabled) != 0;
+}
+
+void binc_stats_reset(void) {
+    for (guint i = 0; i < BINC_STATS_COUNTER_COUNT; i++) {
+        g_atomic_int_set(&counters[i], 0);
+    }
+    for (guint i = 0; i < BINC_STATS_LATENCY_BUCKET_COUNT; i++) {
+        g_atomic_int_set(&latency_buckets[i], 0);
+    }
+}
+
+void binc_internal_stats_add(StatsCounter counter, gint delta) {
+    if (!binc_stats_is_enabled()) return;
+    g_atomic_int_add(&counters[counter], delta);
+}
+
+void binc_internal_stats_record_notify_latency(gint64 millis) {
+    if (!binc_stats_is_enabled()) return;
+
+    guint bucket = BINC_STATS_LATENCY_BUCKET_COUNT - 1;
+    for (guint i = 0; i < BINC_STATS_LATENCY_BUCKET_COUNT - 1; i++) {
+        if (millis < latency_upper_bounds_ms[i]) {
+            bucket = i;
+            break;
+        }
+    }
+    g_atomic_int_add(&latency_buckets[bucket], 1);
+}
+
+void binc_internal_stats_snapshot(Stats *stats) {
+    g_assert(stats != NULL);
+
+    for (guint i = 0; i < BINC_STATS_COUNTER_COUNT; i++) {
+        stats->counters[i] = (guint) g_atomic_int_get(&counters[i]);
+    }
+    for (guint i = 0; i < BINC_STATS_LATENCY_BUCKET_COUNT; i++) {
+        stats->notify_latency_buckets[i] = (guint) g_atomic_int_get(&latency_buckets[i]);
+    }
+    stats->devices_cached = 0;
+    stats->connect_queue_depth = 0;
+}
@@ -0,0 +1,83 @@
+/*
+ *   Copyright (c) 2022 Martijn van Welie
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy
+ *   of this software and associated documentation files (the "Software"), to deal
+ *   in the Software without restriction, including without limitation the rights
+ *   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *   copies of the Software, and to permit persons to whom the Software is
+ *   furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included in all
+ *   copies or substantial portions of the Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *   SOFTWARE.
+ *
+ */
+
+#ifndef BINC_STATS_H
+#define BINC_STATS_H
+
+#include <glib.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum StatsCounter {
+    BINC_STATS_DBUS_CALLS = 0,              // async D-Bus method calls started
+    BINC_STATS_DISCOVERY_RESULTS,           // discovery results delivered
+    BINC_STATS_NOTIFICATIONS_RECEIVED,      // notification values received (central)
+    BINC_STATS_NOTIFICATIONS_SENT,          // notifications emitted (peripheral)
+    BINC_STATS_CHAR_READS,                  // characteristic reads started
+    BINC_STATS_CHAR_WRITES,                 // characteristic writes started
+    BINC_STATS_WRITE_QUEUE_DEPTH,           // gauge, values queued in write queues
+    BINC_STATS_COUNTER_COUNT
+} StatsCounter;
+
+#define BINC_STATS_LATENCY_BUCKET_COUNT 8
+
+/**
+ * Snapshot of the library's counters, taken with binc_adapter_get_stats().
+ *
+ * The notify latency histogram counts notification callback delivery times
+ * with bucket upper bounds of 1, 2, 5, 10, 20, 50 and 100 milliseconds; the
+ * last bucket counts everything slower.
+ */
+typedef struct binc_stats {
+    guint counters[BINC_STATS_COUNTER_COUNT];
+    guint notify_latency_buckets[BINC_STATS_LATENCY_BUCKET_COUNT];
+    guint devices_cached;        // gauge, devices in the adapter's cache
+    guint connect_queue_depth;   // gauge, devices waiting in binc_adapter_connect_all
+} Stats;
+
+/**
+ * Enable or disable stats collection. Disabled by default; when disabled the
+ * hot-path instrumentation is a single flag check.
+ */
+void binc_stats_set_enabled(gboolean enabled);
+
+gboolean binc_stats_is_enabled(void);
+
+/**
+ * Reset all counters and histograms to zero.
+ */
+void binc_stats_reset(void);
+
+void binc_internal_stats_add(StatsCounter counter, gint delta); // make this internal
+
+void binc_internal_stats_record_notify_latency(gint64 millis); // make this internal
+
+void binc_internal_stats_snapshot(Stats *stats); // make this internal
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //BINC_STATS_H
@@ -160,4 +160,35 @@ char* random_string(gsize length) {
     }
 
     return g_string_free(string, FALSE);
-}
\ No newline at end of file
+}
+static guint binc_internal_attach_source(GSource *source, GSourceFunc function, gpointer data) {
+    g_source_set_callback(source, function, data, NULL);
+    guint id = g_source_attach(source, g_main_context_get_thread_default());
+    g_source_unref(source);
+    return id;
+}
+
+guint binc_timeout_add(guint interval_ms, GSourceFunc function, gpointer data) {
+    g_assert(function != NULL);
+    return binc_internal_attach_source(g_timeout_source_new(interval_ms), function, data);
+}
+
+guint binc_idle_add(GSourceFunc function, gpointer data) {
+    g_assert(function != NULL);
+    return binc_internal_attach_source(g_idle_source_new(), function, data);
+}
+
+guint binc_unix_fd_add(gint fd, GIOCondition condition, GUnixFDSourceFunc function, gpointer data) {
+    g_assert(fd >= 0);
+    g_assert(function != NULL);
+    return binc_internal_attach_source(g_unix_fd_source_new(fd, condition), (GSourceFunc) function, data);
+}
+
+void binc_source_remove(guint source_id) {
+    g_assert(source_id > 0);
+
+    GSource *source = g_main_context_find_source_by_id(g_main_context_get_thread_default(), source_id);
+    if (source != NULL) {
+        g_source_destroy(source);
+    }
+}
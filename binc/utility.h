@@ -25,6 +25,7 @@
 #define BINC_UTILITY_H
 
 #include <glib.h>
+#include <glib-unix.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -50,6 +51,25 @@ char* replace_char(char* str, char find, char replace);
 
 char* random_string(gsize length);
 
+/*
+ * Main context helpers. GLib's g_timeout_add/g_idle_add always attach to the
+ * global default GMainContext, while GDBus delivers signals and async call
+ * completions to the thread-default context of the thread that subscribed.
+ * These helpers attach to the thread-default context instead, so the whole
+ * library follows one context: run a dedicated thread that pushes its own
+ * context with g_main_context_push_thread_default(), creates the dbus
+ * connection and adapters there and spins a GMainLoop on it, and all library
+ * I/O, timers and callbacks stay on that thread. From other threads, call
+ * into the library via g_main_context_invoke() on that same context.
+ */
+guint binc_timeout_add(guint interval_ms, GSourceFunc function, gpointer data);
+
+guint binc_idle_add(GSourceFunc function, gpointer data);
+
+guint binc_unix_fd_add(gint fd, GIOCondition condition, GUnixFDSourceFunc function, gpointer data);
+
+void binc_source_remove(guint source_id);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,116 @@
+/*
+ *   Copyright (c) 2022 Martijn van Welie
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy
+ *   of this software and associated documentation files (the "Software"), to deal
+ *   in the Software without restriction, including without limitation the rights
+ *   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *   copies of the Software, and to permit persons to whom the Software is
+ *   furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included in all
+ *   copies or substantial portions of the Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *   SOFTWARE.
+ *
+ */
+
+#include "uuid.h"
+#include <string.h>
+
+#define UUID_STRING_LENGTH 36
+
+typedef struct binc_uuid_entry {
+    Uuid value;
+    char *string; // Owned, canonical lowercase form
+} UuidEntry;
+
+static GMutex interning_mutex;
+static GHashTable *interned_uuids = NULL; // canonical string -> UuidEntry
+
+static gint hex_nibble(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+gboolean binc_uuid_parse(Uuid *uuid, const char *string) {
+    g_assert(uuid != NULL);
+
+    if (string == NULL || strlen(string) != UUID_STRING_LENGTH) return FALSE;
+
+    guint64 halves[2] = {0, 0};
+    guint nibbles = 0;
+    for (guint i = 0; i < UUID_STRING_LENGTH; i++) {
+        if (i == 8 || i == 13 || i == 18 || i == 23) {
+            if (string[i] != '-') return FALSE;
+            continue;
+        }
+        gint nibble = hex_nibble(string[i]);
+        if (nibble < 0) return FALSE;
+        halves[nibbles / 16] = (halves[nibbles / 16] << 4) | (guint64) nibble;
+        nibbles++;
+    }
+
+    uuid->msb = halves[0];
+    uuid->lsb = halves[1];
+    return TRUE;
+}
+
+void binc_uuid_unparse(const Uuid *uuid, char *buffer) {
+    g_assert(uuid != NULL);
+    g_assert(buffer != NULL);
+
+    g_snprintf(buffer, UUID_STRING_LENGTH + 1, "%08x-%04x-%04x-%04x-%012llx",
+               (guint32) (uuid->msb >> 32),
+               (guint16) (uuid->msb >> 16),
+               (guint16) uuid->msb,
+               (guint16) (uuid->lsb >> 48),
+               (unsigned long long) (uuid->lsb & 0xffffffffffffULL));
+}
+
+gboolean binc_uuid_equal(const Uuid *a, const Uuid *b) {
+    g_assert(a != NULL);
+    g_assert(b != NULL);
+    return a->msb == b->msb && a->lsb == b->lsb;
+}
+
+static UuidEntry *binc_internal_uuid_get_entry(const char *string) {
+    Uuid uuid;
+    if (!binc_uuid_parse(&uuid, string)) return NULL;
+
+    char canonical[UUID_STRING_LENGTH + 1];
+    binc_uuid_unparse(&uuid, canonical);
+
+    g_mutex_lock(&interning_mutex);
+    if (interned_uuids == NULL) {
+        interned_uuids = g_hash_table_new(g_str_hash, g_str_equal);
+    }
+
+    UuidEntry *entry = g_hash_table_lookup(interned_uuids, canonical);
+    if (entry == NULL) {
+        entry = g_new0(UuidEntry, 1);
+        entry->value = uuid;
+        entry->string = g_strdup(canonical);
+        g_hash_table_insert(interned_uuids, entry->string, entry);
+    }
+    g_mutex_unlock(&interning_mutex);
+    return entry;
+}
+
+const Uuid *binc_uuid_intern(const char *string) {
+    UuidEntry *entry = binc_internal_uuid_get_entry(string);
+    return entry != NULL ? &entry->value : NULL;
+}
+
+const char *binc_uuid_intern_string(const char *string) {
+    UuidEntry *entry = binc_internal_uuid_get_entry(string);
+    return entry != NULL ? entry->string : NULL;
+}
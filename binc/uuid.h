@@ -0,0 +1,91 @@
+/*
+ *   Copyright (c) 2022 Martijn van Welie
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy
+ *   of this software and associated documentation files (the "Software"), to deal
+ *   in the Software without restriction, including without limitation the rights
+ *   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *   copies of the Software, and to permit persons to whom the Software is
+ *   furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included in all
+ *   copies or substantial portions of the Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *   SOFTWARE.
+ *
+ */
+
+#ifndef BINC_UUID_H
+#define BINC_UUID_H
+
+#include <glib.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * A 128-bit UUID as two 64-bit halves, so comparing two UUIDs is two
+ * integer compares instead of a 36-byte strcmp.
+ */
+typedef struct binc_uuid {
+    guint64 msb;
+    guint64 lsb;
+} Uuid;
+
+/**
+ * Parse a UUID string ("0000180d-0000-1000-8000-00805f9b34fb") into its binary form.
+ *
+ * @param uuid the uuid to fill
+ * @param string the uuid string to parse
+ * @return TRUE when the string was a valid uuid
+ */
+gboolean binc_uuid_parse(Uuid *uuid, const char *string);
+
+/**
+ * Format a binary UUID as its canonical lowercase string.
+ *
+ * @param uuid the uuid
+ * @param buffer buffer of at least 37 bytes to write the string into
+ */
+void binc_uuid_unparse(const Uuid *uuid, char *buffer);
+
+/**
+ * Compare two binary UUIDs.
+ */
+gboolean binc_uuid_equal(const Uuid *a, const Uuid *b);
+
+/**
+ * Intern a UUID string and get its binary form.
+ *
+ * Interned UUIDs live for the lifetime of the process and are allocated only
+ * once per distinct UUID, so two interned pointers are equal exactly when the
+ * UUIDs are equal.
+ *
+ * @param string the uuid string to intern
+ * @return the interned uuid (never free), or NULL when the string is not a valid uuid
+ */
+const Uuid *binc_uuid_intern(const char *string);
+
+/**
+ * Intern a UUID string and get its canonical lowercase string form.
+ *
+ * Like binc_uuid_intern(), the returned string is allocated once per distinct
+ * UUID and never freed, so interned strings can be compared by pointer.
+ *
+ * @param string the uuid string to intern
+ * @return the interned string (never free), or NULL when the string is not a valid uuid
+ */
+const char *binc_uuid_intern_string(const char *string);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //BINC_UUID_H